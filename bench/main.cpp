@@ -0,0 +1,527 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <tnt/audio/multisignal.hpp>
+#include <tnt/audio/trace.hpp>
+#include <tnt/audio/wave_file.hpp>
+#include <tnt/audio/wave_transcode.hpp>
+
+using namespace tnt;
+
+namespace
+{
+
+// Command line settings
+struct bench_options
+{
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "audio_bench";
+
+    std::vector<size_t> channels{1, 2, 8, 64};
+    std::vector<double> durations{1, 10, 100, 1000};
+
+    // Cases with larger files are skipped
+    uint64_t max_file_size = uint64_t{256} << 20;
+
+    // Operations that decode or encode the whole signal at once are skipped above this size
+    uint64_t max_signal_size = uint64_t{1} << 30;
+
+    size_t repeat = 3;
+    bool   json   = false;
+    bool   help   = false;
+
+    // Trace of the file operations to write (none if empty)
+    std::filesystem::path trace;
+};
+
+// One timed operation
+struct bench_result
+{
+    std::string           operation;
+    audio::wave_subformat subformat;
+    size_t                channels;
+    size_t                sample_rate;
+    size_t                frames;
+    uint64_t              bytes;
+    double                seconds;
+};
+
+constexpr size_t sample_rate  = 48000;
+constexpr size_t block_frames = 65536;
+
+const char* name(const audio::wave_subformat& subformat)
+{
+    switch (subformat)
+    {
+        case audio::wave_subformat::pcm_uint8:
+        {
+            return "pcm_uint8";
+        }
+        case audio::wave_subformat::pcm_int16:
+        {
+            return "pcm_int16";
+        }
+        case audio::wave_subformat::pcm_int24:
+        {
+            return "pcm_int24";
+        }
+        case audio::wave_subformat::pcm_int32:
+        {
+            return "pcm_int32";
+        }
+        case audio::wave_subformat::ieee_float32:
+        {
+            return "ieee_float32";
+        }
+        case audio::wave_subformat::ieee_float64:
+        {
+            return "ieee_float64";
+        }
+        default:
+        {
+            return "unknown";
+        }
+    }
+}
+
+audio::wave_format format(const audio::wave_subformat& subformat)
+{
+    return subformat == audio::wave_subformat::ieee_float32
+                || subformat == audio::wave_subformat::ieee_float64
+             ? audio::wave_format::ieee_float
+             : audio::wave_format::pcm;
+}
+
+// Fills frames of a block with a sine per channel plus noise from a fixed seed, so every run
+// generates exactly the same files
+void generate(audio::multisignal<float>& block, size_t start_frame, size_t frames)
+{
+    for (size_t n = 0; n < frames; ++n)
+    {
+        const auto frame = start_frame + n;
+        for (size_t c = 0; c < block.channels(); ++c)
+        {
+            // SplitMix64 of the sample index
+            auto x = (static_cast<uint64_t>(frame) * block.channels() + c + 1)
+                   * 0x9E3779B97F4A7C15ULL;
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+            x ^= x >> 31;
+
+            const auto noise = static_cast<double>(x >> 11) / (uint64_t{1} << 53) - 0.5;
+            const auto phase = 6.283185307179586 * 440.0 * (c + 1) * frame / sample_rate;
+
+            block[n][c] = static_cast<float>(0.5 * std::sin(phase) + 0.1 * noise);
+        }
+    }
+}
+
+// Writes a synthetic file a block at a time so it never has to fit in memory
+void write_synthetic(const std::filesystem::path& path,
+                     const audio::wave_subformat& subformat,
+                     size_t                       channels,
+                     size_t                       frames)
+{
+    auto writer = audio::wave_file<float>(path).open_writer(sample_rate,
+                                                            channels,
+                                                            format(subformat),
+                                                            subformat);
+
+    audio::multisignal<float> block(sample_rate, block_frames, channels);
+    for (size_t frame = 0; frame < frames; frame += block_frames)
+    {
+        const auto count = std::min(block_frames, frames - frame);
+        generate(block, frame, count);
+        writer.write(block, count);
+    }
+
+    writer.finalize();
+}
+
+// Runs an operation repeatedly and keeps the fastest time
+double measure(size_t repeat, const std::function<void()>& operation)
+{
+    auto best = std::numeric_limits<double>::max();
+    for (size_t i = 0; i < repeat; ++i)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        operation();
+        const auto end = std::chrono::steady_clock::now();
+
+        best = std::min(best, std::chrono::duration<double>(end - start).count());
+    }
+
+    return best;
+}
+
+std::vector<bench_result> run_case(const bench_options&         options,
+                                   const audio::wave_subformat& subformat,
+                                   size_t                       channels,
+                                   size_t                       frames)
+{
+    const auto sample_size = audio::detail::sample_size(subformat);
+    const auto signal_size = static_cast<uint64_t>(frames) * channels * sizeof(float);
+    const auto whole       = signal_size <= options.max_signal_size;
+
+    const auto path   = options.directory / "bench.wav";
+    const auto output = options.directory / "bench-output.wav";
+
+    // Times an operation that processes the given number of frames of the file
+    std::vector<bench_result> results;
+    const auto run = [&](const std::string& operation, size_t count, const auto& function) {
+        const auto bytes   = static_cast<uint64_t>(count) * channels * sample_size;
+        const auto seconds = measure(options.repeat, function);
+        results.push_back({operation, subformat, channels, sample_rate, count, bytes, seconds});
+    };
+
+    write_synthetic(path, subformat, channels, frames);
+
+    // Writing one generated block over and over keeps signal generation out of the timing
+    audio::multisignal<float> block(sample_rate, block_frames, channels);
+    generate(block, 0, block_frames);
+
+    run("write_block", frames, [&] {
+        auto writer = audio::wave_file<float>(output).open_writer(sample_rate,
+                                                                  channels,
+                                                                  format(subformat),
+                                                                  subformat);
+
+        for (size_t frame = 0; frame < frames; frame += block_frames)
+        {
+            writer.write(block, std::min(block_frames, frames - frame));
+        }
+
+        writer.finalize();
+    });
+
+    std::filesystem::remove(output);
+
+    if (whole)
+    {
+        audio::multisignal<float> signal(sample_rate, frames, channels);
+        generate(signal, 0, frames);
+
+        run("write", frames, [&] {
+            audio::wave_file<float>(output).write(signal, format(subformat), subformat);
+        });
+
+        std::filesystem::remove(output);
+    }
+
+    // A tenth of the file from the middle
+    const auto range_frames = std::max<size_t>(1, frames / 10);
+    const auto range_start  = frames / 2 - range_frames / 2;
+
+    for (const auto mode : {audio::wave_read_mode::stream,
+                            audio::wave_read_mode::mapped,
+                            audio::wave_read_mode::parallel})
+    {
+        const std::string suffix = mode == audio::wave_read_mode::stream ? "_stream"
+                                 : mode == audio::wave_read_mode::mapped ? "_mapped"
+                                                                         : "_parallel";
+
+        if (whole)
+        {
+            run("read" + suffix, frames, [&] { audio::wave_file<float>(path, mode).read(); });
+        }
+
+        run("read_range" + suffix, range_frames, [&] {
+            audio::wave_file<float>(path, mode).read(range_start, range_frames);
+        });
+    }
+
+    run("read_block", frames, [&] {
+        auto reader = audio::wave_file<float>(path).open_reader();
+        while (reader.read(block) != 0)
+        {
+        }
+    });
+
+    run("read_async", frames, [&] {
+        auto reader = audio::wave_file<float>(path).open_async_reader();
+        while (reader.read(block) != 0)
+        {
+        }
+    });
+
+    run("transcode_pcm_int16", frames, [&] {
+        audio::transcode_wave_file(path,
+                                   output,
+                                   audio::wave_format::pcm,
+                                   audio::wave_subformat::pcm_int16);
+    });
+
+    std::filesystem::remove(output);
+    std::filesystem::remove(path);
+
+    return results;
+}
+
+void print_csv_header()
+{
+    std::cout << "operation,subformat,channels,sample_rate,frames,bytes,seconds,mb_per_s,"
+                 "frames_per_s\n";
+}
+
+void print(const bench_result& result, const bench_options& options, bool first)
+{
+    const auto mb_per_s     = result.bytes / 1e6 / result.seconds;
+    const auto frames_per_s = result.frames / result.seconds;
+
+    if (options.json)
+    {
+        std::cout << (first ? "" : ",\n") << "  {\"operation\": \"" << result.operation
+                  << "\", \"subformat\": \"" << name(result.subformat)
+                  << "\", \"channels\": " << result.channels
+                  << ", \"sample_rate\": " << result.sample_rate
+                  << ", \"frames\": " << result.frames << ", \"bytes\": " << result.bytes
+                  << ", \"seconds\": " << result.seconds << ", \"mb_per_s\": " << mb_per_s
+                  << ", \"frames_per_s\": " << frames_per_s << "}";
+    }
+    else
+    {
+        std::cout << result.operation << ',' << name(result.subformat) << ',' << result.channels
+                  << ',' << result.sample_rate << ',' << result.frames << ',' << result.bytes
+                  << ',' << result.seconds << ',' << mb_per_s << ',' << frames_per_s << '\n';
+    }
+}
+
+// Parses a size with an optional K, M or G suffix (powers of 1024)
+uint64_t parse_size(const std::string& text)
+{
+    size_t     end{};
+    const auto value = std::stod(text, &end);
+
+    double scale = 1;
+    if (end < text.size())
+    {
+        switch (text[end])
+        {
+            case 'K':
+            case 'k':
+            {
+                scale = 1024.0;
+                break;
+            }
+            case 'M':
+            case 'm':
+            {
+                scale = 1024.0 * 1024;
+                break;
+            }
+            case 'G':
+            case 'g':
+            {
+                scale = 1024.0 * 1024 * 1024;
+                break;
+            }
+            default:
+            {
+                throw std::invalid_argument("Invalid size '" + text + "'");
+            }
+        }
+    }
+
+    return static_cast<uint64_t>(value * scale);
+}
+
+template <typename U, typename Parse>
+std::vector<U> parse_list(const std::string& text, const Parse& parse)
+{
+    std::vector<U> values;
+    size_t         start = 0;
+    while (start <= text.size())
+    {
+        const auto end = std::min(text.find(',', start), text.size());
+        values.push_back(static_cast<U>(parse(text.substr(start, end - start))));
+        start = end + 1;
+    }
+
+    return values;
+}
+
+void print_usage()
+{
+    std::cerr
+        << "Usage: audio_bench [options]\n"
+           "\n"
+           "Measures read and write throughput of wave files generated at run time. Throughput\n"
+           "is reported in MB (10^6 bytes) of encoded sample data per second.\n"
+           "\n"
+           "  --dir PATH          Directory for the temporary files\n"
+           "  --channels LIST     Channel counts to test (default 1,2,8,64)\n"
+           "  --durations LIST    Durations to test in seconds (default 1,10,100,1000)\n"
+           "  --max-file-size N   Skip cases with larger files (default 256M, e.g. 8G)\n"
+           "  --max-signal-size N Skip whole-signal operations above this size (default 1G)\n"
+           "  --repeat N          Repetitions per operation, the fastest is reported (default 3)\n"
+           "  --json              Print a JSON array instead of CSV\n"
+           "  --trace PATH        Write a Chrome trace of the file operations\n"
+           "  --help              Print this message\n";
+}
+
+bench_options parse_options(int argc, char** argv)
+{
+    bench_options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string argument = argv[i];
+        const auto        value    = [&]() -> std::string {
+            if (i + 1 >= argc)
+            {
+                throw std::invalid_argument("Missing value for " + argument);
+            }
+
+            return argv[++i];
+        };
+
+        if (argument == "--dir")
+        {
+            options.directory = value();
+        }
+        else if (argument == "--channels")
+        {
+            options.channels = parse_list<size_t>(value(), [](const std::string& text) {
+                return std::stoull(text);
+            });
+        }
+        else if (argument == "--durations")
+        {
+            options.durations = parse_list<double>(value(), [](const std::string& text) {
+                return std::stod(text);
+            });
+        }
+        else if (argument == "--max-file-size")
+        {
+            options.max_file_size = parse_size(value());
+        }
+        else if (argument == "--max-signal-size")
+        {
+            options.max_signal_size = parse_size(value());
+        }
+        else if (argument == "--repeat")
+        {
+            options.repeat = std::max<size_t>(1, std::stoull(value()));
+        }
+        else if (argument == "--json")
+        {
+            options.json = true;
+        }
+        else if (argument == "--trace")
+        {
+            options.trace = value();
+        }
+        else if (argument == "--help")
+        {
+            options.help = true;
+        }
+        else
+        {
+            throw std::invalid_argument("Unknown option " + argument);
+        }
+    }
+
+    return options;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    bench_options options;
+    try
+    {
+        options = parse_options(argc, argv);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << "\n\n";
+        print_usage();
+        return EXIT_FAILURE;
+    }
+
+    if (options.help)
+    {
+        print_usage();
+        return EXIT_SUCCESS;
+    }
+
+    std::filesystem::create_directories(options.directory);
+
+    if (!options.trace.empty())
+    {
+        audio::start_trace(options.trace);
+    }
+
+    if (options.json)
+    {
+        std::cout << "[\n";
+    }
+    else
+    {
+        print_csv_header();
+    }
+
+    bool first = true;
+    for (const auto subformat : {audio::wave_subformat::pcm_uint8,
+                                 audio::wave_subformat::pcm_int16,
+                                 audio::wave_subformat::pcm_int24,
+                                 audio::wave_subformat::pcm_int32,
+                                 audio::wave_subformat::ieee_float32,
+                                 audio::wave_subformat::ieee_float64})
+    {
+        for (const auto channels : options.channels)
+        {
+            for (const auto duration : options.durations)
+            {
+                const auto frames = static_cast<size_t>(duration * sample_rate);
+                const auto size   = static_cast<uint64_t>(frames) * channels
+                                * audio::detail::sample_size(subformat);
+
+                if (frames == 0 || size > options.max_file_size)
+                {
+                    continue;
+                }
+
+                std::cerr << name(subformat) << ", " << channels << " channels, " << duration
+                          << " s\n";
+
+                try
+                {
+                    for (const auto& result : run_case(options, subformat, channels, frames))
+                    {
+                        print(result, options, first);
+                        first = false;
+                    }
+                }
+                catch (const std::exception& e)
+                {
+                    std::cerr << "Failed: " << e.what() << '\n';
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+    }
+
+    if (options.json)
+    {
+        std::cout << "\n]\n";
+    }
+
+    audio::stop_trace();
+
+    std::error_code error{};
+    std::filesystem::remove(options.directory, error);
+
+    return EXIT_SUCCESS;
+}
@@ -31,7 +31,7 @@ class CppAudio(ConanFile):
         "math/1.0.1@tnt-coders/stable",
     )
 
-    exports_sources = ("CMakeLists.txt", "docs/*", "include/*", "src/*", "test/*")
+    exports_sources = ("CMakeLists.txt", "bench/*", "docs/*", "include/*", "src/*", "test/*")
 
     generators = ("cmake", "cmake_find_package", "cmake_paths")
 
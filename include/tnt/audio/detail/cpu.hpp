@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#    define TNT_AUDIO_X86
+#    if defined(_MSC_VER) && !defined(__clang__)
+#        include <intrin.h>
+#    else
+#        include <cpuid.h>
+#    endif
+#endif
+
+// Allows individual functions to be compiled for instruction sets the rest of the project does not
+// target so they can be selected at runtime
+#if defined(__GNUC__) || defined(__clang__)
+#    define TNT_AUDIO_TARGET(isa) __attribute__((target(isa)))
+#else
+#    define TNT_AUDIO_TARGET(isa)
+#endif
+
+namespace tnt::audio::detail
+{
+
+/*!
+\brief Vector instruction set levels used to select sample conversion kernels
+*/
+enum class simd_level
+{
+    scalar,
+    sse2,
+    avx2,
+    avx512,
+};
+
+#if defined(TNT_AUDIO_X86)
+inline void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t (&registers)[4])
+{
+#    if defined(_MSC_VER) && !defined(__clang__)
+    int values[4]{};
+    __cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (size_t i = 0; i < 4; ++i)
+    {
+        registers[i] = static_cast<uint32_t>(values[i]);
+    }
+#    else
+    __cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#    endif
+}
+
+inline uint64_t xgetbv()
+{
+#    if defined(_MSC_VER) && !defined(__clang__)
+    return _xgetbv(0);
+#    else
+    uint32_t eax{};
+    uint32_t edx{};
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return static_cast<uint64_t>(edx) << 32 | eax;
+#    endif
+}
+
+inline simd_level detect_simd_level()
+{
+    constexpr uint32_t eax = 0;
+    constexpr uint32_t ebx = 1;
+    constexpr uint32_t ecx = 2;
+    constexpr uint32_t edx = 3;
+
+    uint32_t registers[4]{};
+    cpuid(0, 0, registers);
+    const auto max_leaf = registers[eax];
+
+    cpuid(1, 0, registers);
+    const bool sse2    = registers[edx] & (1u << 26);
+    const bool osxsave = registers[ecx] & (1u << 27);
+    const bool avx     = registers[ecx] & (1u << 28);
+
+    if (!sse2)
+    {
+        return simd_level::scalar;
+    }
+
+    if (max_leaf < 7 || !osxsave || !avx)
+    {
+        return simd_level::sse2;
+    }
+
+    // The OS must save the vector registers on context switches for the wider levels to be usable
+    const auto xcr0 = xgetbv();
+    const bool ymm  = (xcr0 & 0x06) == 0x06;
+    const bool zmm  = (xcr0 & 0xE6) == 0xE6;
+
+    cpuid(7, 0, registers);
+    const bool avx2     = registers[ebx] & (1u << 5);
+    const bool avx512f  = registers[ebx] & (1u << 16);
+    const bool avx512bw = registers[ebx] & (1u << 30);
+
+    if (zmm && avx2 && avx512f && avx512bw)
+    {
+        return simd_level::avx512;
+    }
+
+    if (ymm && avx2)
+    {
+        return simd_level::avx2;
+    }
+
+    return simd_level::sse2;
+}
+#else
+inline simd_level detect_simd_level()
+{
+    return simd_level::scalar;
+}
+#endif
+
+// Only these types have vectorized kernels, anything else uses the scalar versions
+template <typename T>
+inline constexpr bool has_simd_kernels = std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+/*!
+\brief Gets the widest vector instruction set supported by the running CPU
+\return SIMD level (detected once and cached)
+*/
+inline simd_level cpu_simd_level()
+{
+    static const simd_level level = detect_simd_level();
+    return level;
+}
+
+}  // namespace tnt::audio::detail
@@ -0,0 +1,589 @@
+#pragma once
+
+#include "cpu.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(TNT_AUDIO_X86)
+#    include <immintrin.h>
+#endif
+
+namespace tnt::audio::detail
+{
+
+// Reciprocals of the full scale value of each PCM type. These are all powers of two, so
+// multiplying by them produces exactly the same result as dividing by the full scale value.
+template <typename T>
+inline constexpr T pcm_uint8_scale = static_cast<T>(1) / 0x80;
+
+template <typename T>
+inline constexpr T pcm_int16_scale = static_cast<T>(1) / 0x8000;
+
+template <typename T>
+inline constexpr T pcm_int24_scale = static_cast<T>(1) / 0x800000;
+
+template <typename T>
+inline constexpr T pcm_int32_scale = static_cast<T>(1) / 0x80000000;
+
+template <typename T>
+void decode_pcm_uint8_scalar(const std::byte* data, T* samples, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto value = static_cast<int32_t>(std::to_integer<uint8_t>(data[i])) - 0x80;
+        samples[i]       = static_cast<T>(value) * pcm_uint8_scale<T>;
+    }
+}
+
+template <typename T>
+void decode_pcm_int16_scalar(const std::byte* data, T* samples, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        int16_t value{};
+        std::memcpy(&value, data + i * sizeof(value), sizeof(value));
+        samples[i] = static_cast<T>(value) * pcm_int16_scale<T>;
+    }
+}
+
+template <typename T>
+void decode_pcm_int24_scalar(const std::byte* data, T* samples, size_t count)
+{
+    for (size_t i = 0; i < count; ++i, data += 3)
+    {
+        // Shift the 24 bit two's complement value into the top of a 32 bit integer so the
+        // arithmetic shift back down sign extends it
+        const auto value = static_cast<uint32_t>(std::to_integer<uint8_t>(data[0])) << 8
+                         | static_cast<uint32_t>(std::to_integer<uint8_t>(data[1])) << 16
+                         | static_cast<uint32_t>(std::to_integer<uint8_t>(data[2])) << 24;
+
+        samples[i] = static_cast<T>(static_cast<int32_t>(value) >> 8) * pcm_int24_scale<T>;
+    }
+}
+
+template <typename T>
+void decode_pcm_int32_scalar(const std::byte* data, T* samples, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        int32_t value{};
+        std::memcpy(&value, data + i * sizeof(value), sizeof(value));
+        samples[i] = static_cast<T>(value) * pcm_int32_scale<T>;
+    }
+}
+
+#if defined(TNT_AUDIO_X86)
+TNT_AUDIO_TARGET("sse2")
+inline __m128i load_si128(const std::byte* data)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+}
+
+// Converts four 32 bit integers to samples and stores them
+template <typename T>
+TNT_AUDIO_TARGET("sse2")
+inline void store_sse2(T* samples, __m128i values, T scale)
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        _mm_storeu_ps(samples, _mm_mul_ps(_mm_cvtepi32_ps(values), _mm_set1_ps(scale)));
+    }
+    else
+    {
+        const auto s = _mm_set1_pd(scale);
+        _mm_storeu_pd(samples, _mm_mul_pd(_mm_cvtepi32_pd(values), s));
+        _mm_storeu_pd(samples + 2,
+                      _mm_mul_pd(_mm_cvtepi32_pd(_mm_shuffle_epi32(values, 0x0E)), s));
+    }
+}
+
+template <typename T>
+TNT_AUDIO_TARGET("sse2")
+void decode_pcm_uint8_sse2(const std::byte* data, T* samples, size_t count)
+{
+    const auto zero   = _mm_setzero_si128();
+    const auto offset = _mm_set1_epi32(0x80);
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const auto lo    = _mm_unpacklo_epi8(bytes, zero);
+        const auto hi    = _mm_unpackhi_epi8(bytes, zero);
+
+        const auto scale = pcm_uint8_scale<T>;
+        store_sse2(samples + i, _mm_sub_epi32(_mm_unpacklo_epi16(lo, zero), offset), scale);
+        store_sse2(samples + i + 4, _mm_sub_epi32(_mm_unpackhi_epi16(lo, zero), offset), scale);
+        store_sse2(samples + i + 8, _mm_sub_epi32(_mm_unpacklo_epi16(hi, zero), offset), scale);
+        store_sse2(samples + i + 12, _mm_sub_epi32(_mm_unpackhi_epi16(hi, zero), offset), scale);
+    }
+
+    decode_pcm_uint8_scalar(data + i, samples + i, count - i);
+}
+
+template <typename T>
+TNT_AUDIO_TARGET("sse2")
+void decode_pcm_int16_sse2(const std::byte* data, T* samples, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const auto values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 2));
+
+        // Place each value in the top half of a 32 bit lane and shift it back down to sign extend
+        const auto lo = _mm_srai_epi32(_mm_unpacklo_epi16(values, values), 16);
+        const auto hi = _mm_srai_epi32(_mm_unpackhi_epi16(values, values), 16);
+
+        store_sse2(samples + i, lo, pcm_int16_scale<T>);
+        store_sse2(samples + i + 4, hi, pcm_int16_scale<T>);
+    }
+
+    decode_pcm_int16_scalar(data + i * 2, samples + i, count - i);
+}
+
+template <typename T>
+TNT_AUDIO_TARGET("sse2")
+void decode_pcm_int32_sse2(const std::byte* data, T* samples, size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const auto values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 4));
+        store_sse2(samples + i, values, pcm_int32_scale<T>);
+    }
+
+    decode_pcm_int32_scalar(data + i * 4, samples + i, count - i);
+}
+
+// Converts eight 32 bit integers to samples and stores them
+template <typename T>
+TNT_AUDIO_TARGET("avx2")
+inline void store_avx2(T* samples, __m256i values, T scale)
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        _mm256_storeu_ps(samples, _mm256_mul_ps(_mm256_cvtepi32_ps(values), _mm256_set1_ps(scale)));
+    }
+    else
+    {
+        const auto s = _mm256_set1_pd(scale);
+        const auto lo = _mm256_cvtepi32_pd(_mm256_castsi256_si128(values));
+        const auto hi = _mm256_cvtepi32_pd(_mm256_extracti128_si256(values, 1));
+        _mm256_storeu_pd(samples, _mm256_mul_pd(lo, s));
+        _mm256_storeu_pd(samples + 4, _mm256_mul_pd(hi, s));
+    }
+}
+
+template <typename T>
+TNT_AUDIO_TARGET("avx2")
+void decode_pcm_uint8_avx2(const std::byte* data, T* samples, size_t count)
+{
+    const auto offset = _mm256_set1_epi32(0x80);
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const auto lo = _mm256_cvtepu8_epi32(
+            _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data + i)));
+        const auto hi = _mm256_cvtepu8_epi32(
+            _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data + i + 8)));
+
+        store_avx2(samples + i, _mm256_sub_epi32(lo, offset), pcm_uint8_scale<T>);
+        store_avx2(samples + i + 8, _mm256_sub_epi32(hi, offset), pcm_uint8_scale<T>);
+    }
+
+    decode_pcm_uint8_scalar(data + i, samples + i, count - i);
+}
+
+template <typename T>
+TNT_AUDIO_TARGET("avx2")
+void decode_pcm_int16_avx2(const std::byte* data, T* samples, size_t count)
+{
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const auto lo = _mm256_cvtepi16_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 2)));
+        const auto hi = _mm256_cvtepi16_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 2 + 16)));
+
+        store_avx2(samples + i, lo, pcm_int16_scale<T>);
+        store_avx2(samples + i + 8, hi, pcm_int16_scale<T>);
+    }
+
+    decode_pcm_int16_scalar(data + i * 2, samples + i, count - i);
+}
+
+template <typename T>
+TNT_AUDIO_TARGET("avx2")
+void decode_pcm_int24_avx2(const std::byte* data, T* samples, size_t count)
+{
+    // Moves each packed 3 byte value into the top of a 32 bit lane (within each 128 bit lane)
+    const auto shuffle = _mm256_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11,
+                                          -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+
+    // Each iteration consumes 24 bytes but the second load reads 28, so stop while there is still
+    // enough data left to not read past the end of the buffer
+    size_t i = 0;
+    for (; i + 10 <= count; i += 8)
+    {
+        const auto lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 3));
+        const auto hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 3 + 12));
+
+        const auto packed = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        const auto values = _mm256_srai_epi32(_mm256_shuffle_epi8(packed, shuffle), 8);
+
+        store_avx2(samples + i, values, pcm_int24_scale<T>);
+    }
+
+    decode_pcm_int24_scalar(data + i * 3, samples + i, count - i);
+}
+
+template <typename T>
+TNT_AUDIO_TARGET("avx2")
+void decode_pcm_int32_avx2(const std::byte* data, T* samples, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const auto values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i * 4));
+        store_avx2(samples + i, values, pcm_int32_scale<T>);
+    }
+
+    decode_pcm_int32_scalar(data + i * 4, samples + i, count - i);
+}
+
+// GCC 12 warns that the AVX-512 intrinsics use their own uninitialized placeholder operand (GCC bug
+// 105593), which would break builds with -Werror
+#if defined(__GNUC__) && !defined(__clang__)
+#    pragma GCC diagnostic push
+#    pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#    pragma GCC diagnostic ignored "-Wuninitialized"
+#endif
+
+// Converts sixteen 32 bit integers to samples and stores them
+template <typename T>
+TNT_AUDIO_TARGET("avx512f,avx512bw")
+inline void store_avx512(T* samples, __m512i values, T scale)
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        _mm512_storeu_ps(samples, _mm512_mul_ps(_mm512_cvtepi32_ps(values), _mm512_set1_ps(scale)));
+    }
+    else
+    {
+        const auto s = _mm512_set1_pd(scale);
+        const auto lo = _mm512_cvtepi32_pd(_mm512_castsi512_si256(values));
+        const auto hi = _mm512_cvtepi32_pd(_mm512_extracti64x4_epi64(values, 1));
+        _mm512_storeu_pd(samples, _mm512_mul_pd(lo, s));
+        _mm512_storeu_pd(samples + 8, _mm512_mul_pd(hi, s));
+    }
+}
+
+template <typename T>
+TNT_AUDIO_TARGET("avx512f,avx512bw")
+void decode_pcm_uint8_avx512(const std::byte* data, T* samples, size_t count)
+{
+    const auto offset = _mm512_set1_epi32(0x80);
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const auto values = _mm512_cvtepu8_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)));
+
+        store_avx512(samples + i, _mm512_sub_epi32(values, offset), pcm_uint8_scale<T>);
+    }
+
+    decode_pcm_uint8_scalar(data + i, samples + i, count - i);
+}
+
+template <typename T>
+TNT_AUDIO_TARGET("avx512f,avx512bw")
+void decode_pcm_int16_avx512(const std::byte* data, T* samples, size_t count)
+{
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const auto values = _mm512_cvtepi16_epi32(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i * 2)));
+
+        store_avx512(samples + i, values, pcm_int16_scale<T>);
+    }
+
+    decode_pcm_int16_scalar(data + i * 2, samples + i, count - i);
+}
+
+template <typename T>
+TNT_AUDIO_TARGET("avx512f,avx512bw")
+void decode_pcm_int24_avx512(const std::byte* data, T* samples, size_t count)
+{
+    // Moves each packed 3 byte value into the top of a 32 bit lane (within each 128 bit lane)
+    const auto shuffle = _mm512_broadcast_i32x4(
+        _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11));
+
+    // Each iteration consumes 48 bytes but the last load reads 52, so stop while there is still
+    // enough data left to not read past the end of the buffer
+    size_t i = 0;
+    for (; i + 18 <= count; i += 16)
+    {
+        const auto* p = data + i * 3;
+
+        // Each 128 bit lane gets the next four packed values (12 bytes)
+        auto packed = _mm512_castsi128_si512(load_si128(p));
+        packed      = _mm512_inserti32x4(packed, load_si128(p + 12), 1);
+        packed      = _mm512_inserti32x4(packed, load_si128(p + 24), 2);
+        packed      = _mm512_inserti32x4(packed, load_si128(p + 36), 3);
+
+        const auto values = _mm512_srai_epi32(_mm512_shuffle_epi8(packed, shuffle), 8);
+
+        store_avx512(samples + i, values, pcm_int24_scale<T>);
+    }
+
+    decode_pcm_int24_scalar(data + i * 3, samples + i, count - i);
+}
+
+template <typename T>
+TNT_AUDIO_TARGET("avx512f,avx512bw")
+void decode_pcm_int32_avx512(const std::byte* data, T* samples, size_t count)
+{
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const auto values = _mm512_loadu_si512(data + i * 4);
+        store_avx512(samples + i, values, pcm_int32_scale<T>);
+    }
+
+    decode_pcm_int32_scalar(data + i * 4, samples + i, count - i);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#    pragma GCC diagnostic pop
+#endif
+#endif
+
+/*!
+\brief Decodes unsigned 8 bit PCM values into samples in the range [-1, 1)
+\param[in] data Packed little endian PCM data
+\param[out] samples Output samples
+\param[in] count Number of samples to decode
+\param[in] level Widest instruction set the kernel may use
+*/
+template <typename T>
+void decode_pcm_uint8(const std::byte* data,
+                      T*               samples,
+                      size_t           count,
+                      simd_level       level = cpu_simd_level())
+{
+#if defined(TNT_AUDIO_X86)
+    if constexpr (has_simd_kernels<T>)
+    {
+        switch (level)
+        {
+            case simd_level::avx512:
+            {
+                return decode_pcm_uint8_avx512(data, samples, count);
+            }
+            case simd_level::avx2:
+            {
+                return decode_pcm_uint8_avx2(data, samples, count);
+            }
+            case simd_level::sse2:
+            {
+                return decode_pcm_uint8_sse2(data, samples, count);
+            }
+            default:
+            {
+                break;
+            }
+        }
+    }
+#endif
+
+    decode_pcm_uint8_scalar(data, samples, count);
+}
+
+/*!
+\brief Decodes signed 16 bit PCM values into samples in the range [-1, 1)
+\copydetails decode_pcm_uint8()
+*/
+template <typename T>
+void decode_pcm_int16(const std::byte* data,
+                      T*               samples,
+                      size_t           count,
+                      simd_level       level = cpu_simd_level())
+{
+#if defined(TNT_AUDIO_X86)
+    if constexpr (has_simd_kernels<T>)
+    {
+        switch (level)
+        {
+            case simd_level::avx512:
+            {
+                return decode_pcm_int16_avx512(data, samples, count);
+            }
+            case simd_level::avx2:
+            {
+                return decode_pcm_int16_avx2(data, samples, count);
+            }
+            case simd_level::sse2:
+            {
+                return decode_pcm_int16_sse2(data, samples, count);
+            }
+            default:
+            {
+                break;
+            }
+        }
+    }
+#endif
+
+    decode_pcm_int16_scalar(data, samples, count);
+}
+
+/*!
+\brief Decodes packed signed 24 bit PCM values into samples in the range [-1, 1)
+\copydetails decode_pcm_uint8()
+
+SSE2 has no byte shuffle, so that level uses the scalar kernel for 24 bit data.
+*/
+template <typename T>
+void decode_pcm_int24(const std::byte* data,
+                      T*               samples,
+                      size_t           count,
+                      simd_level       level = cpu_simd_level())
+{
+#if defined(TNT_AUDIO_X86)
+    if constexpr (has_simd_kernels<T>)
+    {
+        switch (level)
+        {
+            case simd_level::avx512:
+            {
+                return decode_pcm_int24_avx512(data, samples, count);
+            }
+            case simd_level::avx2:
+            {
+                return decode_pcm_int24_avx2(data, samples, count);
+            }
+            default:
+            {
+                break;
+            }
+        }
+    }
+#endif
+
+    decode_pcm_int24_scalar(data, samples, count);
+}
+
+/*!
+\brief Decodes signed 32 bit PCM values into samples in the range [-1, 1)
+\copydetails decode_pcm_uint8()
+*/
+template <typename T>
+void decode_pcm_int32(const std::byte* data,
+                      T*               samples,
+                      size_t           count,
+                      simd_level       level = cpu_simd_level())
+{
+#if defined(TNT_AUDIO_X86)
+    if constexpr (has_simd_kernels<T>)
+    {
+        switch (level)
+        {
+            case simd_level::avx512:
+            {
+                return decode_pcm_int32_avx512(data, samples, count);
+            }
+            case simd_level::avx2:
+            {
+                return decode_pcm_int32_avx2(data, samples, count);
+            }
+            case simd_level::sse2:
+            {
+                return decode_pcm_int32_sse2(data, samples, count);
+            }
+            default:
+            {
+                break;
+            }
+        }
+    }
+#endif
+
+    decode_pcm_int32_scalar(data, samples, count);
+}
+
+/*!
+\brief Decodes 32 bit IEEE float values into samples
+\param[in] data Packed little endian float data
+\param[out] samples Output samples
+\param[in] count Number of samples to decode
+*/
+template <typename T>
+void decode_ieee_float32(const std::byte* data, T* samples, size_t count)
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        // memcpy must not be given the null pointers of empty buffers, even to copy no bytes
+        if (count > 0)
+        {
+            std::memcpy(samples, data, count * sizeof(float));
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            float value{};
+            std::memcpy(&value, data + i * sizeof(value), sizeof(value));
+            samples[i] = static_cast<T>(value);
+        }
+    }
+}
+
+/*!
+\brief Decodes 64 bit IEEE float values into samples
+\copydetails decode_ieee_float32()
+*/
+template <typename T>
+void decode_ieee_float64(const std::byte* data, T* samples, size_t count)
+{
+    if constexpr (std::is_same_v<T, double>)
+    {
+        if (count > 0)
+        {
+            std::memcpy(samples, data, count * sizeof(double));
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            double value{};
+            std::memcpy(&value, data + i * sizeof(value), sizeof(value));
+            samples[i] = static_cast<T>(value);
+        }
+    }
+}
+
+// Decodes a sample every stride bytes with a kernel, which picks a single channel out of
+// interleaved data without touching the samples of the other channels
+template <typename T, typename Kernel>
+void decode_strided(const std::byte* data,
+                    size_t           stride,
+                    T*               samples,
+                    size_t           count,
+                    const Kernel&    kernel)
+{
+    for (size_t i = 0; i < count; ++i, data += stride)
+    {
+        kernel(data, samples + i, 1);
+    }
+}
+
+}  // namespace tnt::audio::detail
@@ -0,0 +1,738 @@
+#pragma once
+
+#include "cpu.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(TNT_AUDIO_X86)
+#    include <immintrin.h>
+#endif
+
+namespace tnt::audio::detail
+{
+
+// Full scale value and range of each PCM type. Samples are scaled, clamped to the range and then
+// rounded to the nearest integer. Every step except the rounding is exact in both float and double,
+// so all kernels produce identical results regardless of the precision they work in.
+struct pcm_range
+{
+    double scale;
+    double min;
+    double max;
+};
+
+inline constexpr pcm_range pcm_uint8_range{0x80, -0x80, 0x7F};
+inline constexpr pcm_range pcm_int16_range{0x8000, -0x8000, 0x7FFF};
+inline constexpr pcm_range pcm_int24_range{0x800000, -0x800000, 0x7FFFFF};
+inline constexpr pcm_range pcm_int32_range{0x80000000, -0x80000000LL, 0x7FFFFFFF};
+
+// Scales, clamps and rounds a single sample. NaN clamps to the minimum like the vector kernels.
+template <typename T>
+inline int32_t quantize(T sample, const pcm_range& range)
+{
+    auto value = static_cast<double>(sample) * range.scale;
+    value      = value > range.min ? value : range.min;
+    value      = value < range.max ? value : range.max;
+    return static_cast<int32_t>(std::nearbyint(value));
+}
+
+template <typename T>
+void encode_pcm_uint8_scalar(const T* samples, std::byte* data, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        data[i] = static_cast<std::byte>(quantize(samples[i], pcm_uint8_range) + 0x80);
+    }
+}
+
+template <typename T>
+void encode_pcm_int16_scalar(const T* samples, std::byte* data, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto value = static_cast<int16_t>(quantize(samples[i], pcm_int16_range));
+        std::memcpy(data + i * sizeof(value), &value, sizeof(value));
+    }
+}
+
+template <typename T>
+void encode_pcm_int24_scalar(const T* samples, std::byte* data, size_t count)
+{
+    for (size_t i = 0; i < count; ++i, data += 3)
+    {
+        // Only write the low 3 bytes of the two's complement value
+        const auto value = static_cast<uint32_t>(quantize(samples[i], pcm_int24_range));
+        data[0]          = static_cast<std::byte>(value);
+        data[1]          = static_cast<std::byte>(value >> 8);
+        data[2]          = static_cast<std::byte>(value >> 16);
+    }
+}
+
+template <typename T>
+void encode_pcm_int32_scalar(const T* samples, std::byte* data, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto value = quantize(samples[i], pcm_int32_range);
+        std::memcpy(data + i * sizeof(value), &value, sizeof(value));
+    }
+}
+
+template <typename T>
+void encode_ieee_float32_scalar(const T* samples, std::byte* data, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto value = static_cast<float>(samples[i]);
+        std::memcpy(data + i * sizeof(value), &value, sizeof(value));
+    }
+}
+
+#if defined(TNT_AUDIO_X86)
+// Quantizes four samples to 32 bit integers, working in float when the input is float
+template <typename T>
+TNT_AUDIO_TARGET("sse2")
+inline __m128i quantize_sse2(const T* samples, const pcm_range& range)
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        auto values = _mm_mul_ps(_mm_loadu_ps(samples),
+                                 _mm_set1_ps(static_cast<float>(range.scale)));
+        values      = _mm_max_ps(values, _mm_set1_ps(static_cast<float>(range.min)));
+        values      = _mm_min_ps(values, _mm_set1_ps(static_cast<float>(range.max)));
+        return _mm_cvtps_epi32(values);
+    }
+    else
+    {
+        const auto scale = _mm_set1_pd(range.scale);
+        const auto min   = _mm_set1_pd(range.min);
+        const auto max   = _mm_set1_pd(range.max);
+
+        auto lo = _mm_mul_pd(_mm_loadu_pd(samples), scale);
+        auto hi = _mm_mul_pd(_mm_loadu_pd(samples + 2), scale);
+        lo      = _mm_min_pd(_mm_max_pd(lo, min), max);
+        hi      = _mm_min_pd(_mm_max_pd(hi, min), max);
+        return _mm_unpacklo_epi64(_mm_cvtpd_epi32(lo), _mm_cvtpd_epi32(hi));
+    }
+}
+
+// Quantizes four samples to 32 bit integers, always working in double so the full 32 bit range is
+// representable
+template <typename T>
+TNT_AUDIO_TARGET("sse2")
+inline __m128i quantize_precise_sse2(const T* samples, const pcm_range& range)
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        const auto values = _mm_loadu_ps(samples);
+        const auto lo     = _mm_cvtps_pd(values);
+        const auto hi     = _mm_cvtps_pd(_mm_movehl_ps(values, values));
+
+        const auto scale = _mm_set1_pd(range.scale);
+        const auto min   = _mm_set1_pd(range.min);
+        const auto max   = _mm_set1_pd(range.max);
+
+        return _mm_unpacklo_epi64(
+            _mm_cvtpd_epi32(_mm_min_pd(_mm_max_pd(_mm_mul_pd(lo, scale), min), max)),
+            _mm_cvtpd_epi32(_mm_min_pd(_mm_max_pd(_mm_mul_pd(hi, scale), min), max)));
+    }
+    else
+    {
+        return quantize_sse2(samples, range);
+    }
+}
+
+template <typename T>
+TNT_AUDIO_TARGET("sse2")
+void encode_pcm_uint8_sse2(const T* samples, std::byte* data, size_t count)
+{
+    const auto offset = _mm_set1_epi32(0x80);
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const auto a = _mm_add_epi32(quantize_sse2(samples + i, pcm_uint8_range), offset);
+        const auto b = _mm_add_epi32(quantize_sse2(samples + i + 4, pcm_uint8_range), offset);
+        const auto c = _mm_add_epi32(quantize_sse2(samples + i + 8, pcm_uint8_range), offset);
+        const auto d = _mm_add_epi32(quantize_sse2(samples + i + 12, pcm_uint8_range), offset);
+
+        const auto bytes = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), bytes);
+    }
+
+    encode_pcm_uint8_scalar(samples + i, data + i, count - i);
+}
+
+template <typename T>
+TNT_AUDIO_TARGET("sse2")
+void encode_pcm_int16_sse2(const T* samples, std::byte* data, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const auto lo = quantize_sse2(samples + i, pcm_int16_range);
+        const auto hi = quantize_sse2(samples + i + 4, pcm_int16_range);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i * 2), _mm_packs_epi32(lo, hi));
+    }
+
+    encode_pcm_int16_scalar(samples + i, data + i * 2, count - i);
+}
+
+template <typename T>
+TNT_AUDIO_TARGET("sse2")
+void encode_pcm_int32_sse2(const T* samples, std::byte* data, size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const auto values = quantize_precise_sse2(samples + i, pcm_int32_range);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i * 4), values);
+    }
+
+    encode_pcm_int32_scalar(samples + i, data + i * 4, count - i);
+}
+
+TNT_AUDIO_TARGET("sse2")
+inline void encode_ieee_float32_sse2(const double* samples, std::byte* data, size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const auto lo = _mm_cvtpd_ps(_mm_loadu_pd(samples + i));
+        const auto hi = _mm_cvtpd_ps(_mm_loadu_pd(samples + i + 2));
+        _mm_storeu_ps(reinterpret_cast<float*>(data + i * 4), _mm_movelh_ps(lo, hi));
+    }
+
+    encode_ieee_float32_scalar(samples + i, data + i * 4, count - i);
+}
+
+// Quantizes eight samples to 32 bit integers, working in float when the input is float
+template <typename T>
+TNT_AUDIO_TARGET("avx2")
+inline __m256i quantize_avx2(const T* samples, const pcm_range& range)
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        auto values = _mm256_mul_ps(_mm256_loadu_ps(samples),
+                                    _mm256_set1_ps(static_cast<float>(range.scale)));
+        values      = _mm256_max_ps(values, _mm256_set1_ps(static_cast<float>(range.min)));
+        values      = _mm256_min_ps(values, _mm256_set1_ps(static_cast<float>(range.max)));
+        return _mm256_cvtps_epi32(values);
+    }
+    else
+    {
+        const auto scale = _mm256_set1_pd(range.scale);
+        const auto min   = _mm256_set1_pd(range.min);
+        const auto max   = _mm256_set1_pd(range.max);
+
+        auto lo = _mm256_mul_pd(_mm256_loadu_pd(samples), scale);
+        auto hi = _mm256_mul_pd(_mm256_loadu_pd(samples + 4), scale);
+        lo      = _mm256_min_pd(_mm256_max_pd(lo, min), max);
+        hi      = _mm256_min_pd(_mm256_max_pd(hi, min), max);
+        return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm256_cvtpd_epi32(lo)),
+                                       _mm256_cvtpd_epi32(hi),
+                                       1);
+    }
+}
+
+// Quantizes eight samples to 32 bit integers, always working in double
+template <typename T>
+TNT_AUDIO_TARGET("avx2")
+inline __m256i quantize_precise_avx2(const T* samples, const pcm_range& range)
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        const auto scale = _mm256_set1_pd(range.scale);
+        const auto min   = _mm256_set1_pd(range.min);
+        const auto max   = _mm256_set1_pd(range.max);
+
+        auto lo = _mm256_mul_pd(_mm256_cvtps_pd(_mm_loadu_ps(samples)), scale);
+        auto hi = _mm256_mul_pd(_mm256_cvtps_pd(_mm_loadu_ps(samples + 4)), scale);
+        lo      = _mm256_min_pd(_mm256_max_pd(lo, min), max);
+        hi      = _mm256_min_pd(_mm256_max_pd(hi, min), max);
+        return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm256_cvtpd_epi32(lo)),
+                                       _mm256_cvtpd_epi32(hi),
+                                       1);
+    }
+    else
+    {
+        return quantize_avx2(samples, range);
+    }
+}
+
+template <typename T>
+TNT_AUDIO_TARGET("avx2")
+void encode_pcm_uint8_avx2(const T* samples, std::byte* data, size_t count)
+{
+    const auto offset = _mm256_set1_epi32(0x80);
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const auto a = _mm256_add_epi32(quantize_avx2(samples + i, pcm_uint8_range), offset);
+        const auto b = _mm256_add_epi32(quantize_avx2(samples + i + 8, pcm_uint8_range), offset);
+
+        const auto lo = _mm_packs_epi32(_mm256_castsi256_si128(a), _mm256_extracti128_si256(a, 1));
+        const auto hi = _mm_packs_epi32(_mm256_castsi256_si128(b), _mm256_extracti128_si256(b, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), _mm_packus_epi16(lo, hi));
+    }
+
+    encode_pcm_uint8_scalar(samples + i, data + i, count - i);
+}
+
+template <typename T>
+TNT_AUDIO_TARGET("avx2")
+void encode_pcm_int16_avx2(const T* samples, std::byte* data, size_t count)
+{
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const auto lo = quantize_avx2(samples + i, pcm_int16_range);
+        const auto hi = quantize_avx2(samples + i + 8, pcm_int16_range);
+
+        // Packing works within 128 bit lanes, so put the 64 bit groups back in order afterwards
+        const auto values = _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + i * 2), values);
+    }
+
+    encode_pcm_int16_scalar(samples + i, data + i * 2, count - i);
+}
+
+template <typename T>
+TNT_AUDIO_TARGET("avx2")
+void encode_pcm_int24_avx2(const T* samples, std::byte* data, size_t count)
+{
+    // Drops the top byte of each 32 bit lane (within each 128 bit lane), then moves the 12 packed
+    // bytes of the upper lane down against the lower lane
+    const auto shuffle = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                                          0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    const auto permute = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const auto values = quantize_avx2(samples + i, pcm_int24_range);
+        const auto packed = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(values, shuffle),
+                                                        permute);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i * 3), _mm256_castsi256_si128(packed));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(data + i * 3 + 16),
+                         _mm256_extracti128_si256(packed, 1));
+    }
+
+    encode_pcm_int24_scalar(samples + i, data + i * 3, count - i);
+}
+
+template <typename T>
+TNT_AUDIO_TARGET("avx2")
+void encode_pcm_int32_avx2(const T* samples, std::byte* data, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const auto values = quantize_precise_avx2(samples + i, pcm_int32_range);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + i * 4), values);
+    }
+
+    encode_pcm_int32_scalar(samples + i, data + i * 4, count - i);
+}
+
+TNT_AUDIO_TARGET("avx2")
+inline void encode_ieee_float32_avx2(const double* samples, std::byte* data, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const auto lo = _mm256_cvtpd_ps(_mm256_loadu_pd(samples + i));
+        const auto hi = _mm256_cvtpd_ps(_mm256_loadu_pd(samples + i + 4));
+        _mm_storeu_ps(reinterpret_cast<float*>(data + i * 4), lo);
+        _mm_storeu_ps(reinterpret_cast<float*>(data + i * 4 + 16), hi);
+    }
+
+    encode_ieee_float32_scalar(samples + i, data + i * 4, count - i);
+}
+
+// Same false positive as in the AVX-512 decode kernels (GCC bug 105593)
+#if defined(__GNUC__) && !defined(__clang__)
+#    pragma GCC diagnostic push
+#    pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#    pragma GCC diagnostic ignored "-Wuninitialized"
+#endif
+
+// Quantizes sixteen samples to 32 bit integers, working in float when the input is float
+template <typename T>
+TNT_AUDIO_TARGET("avx512f,avx512bw")
+inline __m512i quantize_avx512(const T* samples, const pcm_range& range)
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        auto values = _mm512_mul_ps(_mm512_loadu_ps(samples),
+                                    _mm512_set1_ps(static_cast<float>(range.scale)));
+        values      = _mm512_max_ps(values, _mm512_set1_ps(static_cast<float>(range.min)));
+        values      = _mm512_min_ps(values, _mm512_set1_ps(static_cast<float>(range.max)));
+        return _mm512_cvtps_epi32(values);
+    }
+    else
+    {
+        const auto scale = _mm512_set1_pd(range.scale);
+        const auto min   = _mm512_set1_pd(range.min);
+        const auto max   = _mm512_set1_pd(range.max);
+
+        auto lo = _mm512_mul_pd(_mm512_loadu_pd(samples), scale);
+        auto hi = _mm512_mul_pd(_mm512_loadu_pd(samples + 8), scale);
+        lo      = _mm512_min_pd(_mm512_max_pd(lo, min), max);
+        hi      = _mm512_min_pd(_mm512_max_pd(hi, min), max);
+        return _mm512_inserti64x4(_mm512_castsi256_si512(_mm512_cvtpd_epi32(lo)),
+                                  _mm512_cvtpd_epi32(hi),
+                                  1);
+    }
+}
+
+// Quantizes sixteen samples to 32 bit integers, always working in double
+template <typename T>
+TNT_AUDIO_TARGET("avx512f,avx512bw")
+inline __m512i quantize_precise_avx512(const T* samples, const pcm_range& range)
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        const auto scale = _mm512_set1_pd(range.scale);
+        const auto min   = _mm512_set1_pd(range.min);
+        const auto max   = _mm512_set1_pd(range.max);
+
+        auto lo = _mm512_mul_pd(_mm512_cvtps_pd(_mm256_loadu_ps(samples)), scale);
+        auto hi = _mm512_mul_pd(_mm512_cvtps_pd(_mm256_loadu_ps(samples + 8)), scale);
+        lo      = _mm512_min_pd(_mm512_max_pd(lo, min), max);
+        hi      = _mm512_min_pd(_mm512_max_pd(hi, min), max);
+        return _mm512_inserti64x4(_mm512_castsi256_si512(_mm512_cvtpd_epi32(lo)),
+                                  _mm512_cvtpd_epi32(hi),
+                                  1);
+    }
+    else
+    {
+        return quantize_avx512(samples, range);
+    }
+}
+
+template <typename T>
+TNT_AUDIO_TARGET("avx512f,avx512bw")
+void encode_pcm_uint8_avx512(const T* samples, std::byte* data, size_t count)
+{
+    const auto offset = _mm512_set1_epi32(0x80);
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const auto values = _mm512_add_epi32(quantize_avx512(samples + i, pcm_uint8_range), offset);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), _mm512_cvtepi32_epi8(values));
+    }
+
+    encode_pcm_uint8_scalar(samples + i, data + i, count - i);
+}
+
+template <typename T>
+TNT_AUDIO_TARGET("avx512f,avx512bw")
+void encode_pcm_int16_avx512(const T* samples, std::byte* data, size_t count)
+{
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const auto values = quantize_avx512(samples + i, pcm_int16_range);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + i * 2),
+                            _mm512_cvtepi32_epi16(values));
+    }
+
+    encode_pcm_int16_scalar(samples + i, data + i * 2, count - i);
+}
+
+template <typename T>
+TNT_AUDIO_TARGET("avx512f,avx512bw")
+void encode_pcm_int24_avx512(const T* samples, std::byte* data, size_t count)
+{
+    // Drops the top byte of each 32 bit lane (within each 128 bit lane), then gathers the 12 packed
+    // bytes of every lane into the low 48 bytes
+    const auto shuffle = _mm512_broadcast_i32x4(
+        _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1));
+    const auto permute = _mm512_setr_epi32(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 3, 7, 11, 15);
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const auto values = quantize_avx512(samples + i, pcm_int24_range);
+        const auto packed = _mm512_permutexvar_epi32(permute, _mm512_shuffle_epi8(values, shuffle));
+
+        _mm512_mask_storeu_epi8(data + i * 3, 0xFFFFFFFFFFFF, packed);
+    }
+
+    encode_pcm_int24_scalar(samples + i, data + i * 3, count - i);
+}
+
+template <typename T>
+TNT_AUDIO_TARGET("avx512f,avx512bw")
+void encode_pcm_int32_avx512(const T* samples, std::byte* data, size_t count)
+{
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const auto values = quantize_precise_avx512(samples + i, pcm_int32_range);
+        _mm512_storeu_si512(data + i * 4, values);
+    }
+
+    encode_pcm_int32_scalar(samples + i, data + i * 4, count - i);
+}
+
+TNT_AUDIO_TARGET("avx512f,avx512bw")
+inline void encode_ieee_float32_avx512(const double* samples, std::byte* data, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        _mm256_storeu_ps(reinterpret_cast<float*>(data + i * 4),
+                         _mm512_cvtpd_ps(_mm512_loadu_pd(samples + i)));
+    }
+
+    encode_ieee_float32_scalar(samples + i, data + i * 4, count - i);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#    pragma GCC diagnostic pop
+#endif
+#endif
+
+/*!
+\brief Encodes samples in the range [-1, 1] as unsigned 8 bit PCM values
+
+Samples are scaled, clamped to the range of the PCM type and rounded to the nearest integer.
+
+\param[in] samples Input samples
+\param[out] data Packed little endian PCM data
+\param[in] count Number of samples to encode
+\param[in] level Widest instruction set the kernel may use
+*/
+template <typename T>
+void encode_pcm_uint8(const T*   samples,
+                      std::byte* data,
+                      size_t     count,
+                      simd_level level = cpu_simd_level())
+{
+#if defined(TNT_AUDIO_X86)
+    if constexpr (has_simd_kernels<T>)
+    {
+        switch (level)
+        {
+            case simd_level::avx512:
+            {
+                return encode_pcm_uint8_avx512(samples, data, count);
+            }
+            case simd_level::avx2:
+            {
+                return encode_pcm_uint8_avx2(samples, data, count);
+            }
+            case simd_level::sse2:
+            {
+                return encode_pcm_uint8_sse2(samples, data, count);
+            }
+            default:
+            {
+                break;
+            }
+        }
+    }
+#endif
+
+    encode_pcm_uint8_scalar(samples, data, count);
+}
+
+/*!
+\brief Encodes samples in the range [-1, 1] as signed 16 bit PCM values
+\copydetails encode_pcm_uint8()
+*/
+template <typename T>
+void encode_pcm_int16(const T*   samples,
+                      std::byte* data,
+                      size_t     count,
+                      simd_level level = cpu_simd_level())
+{
+#if defined(TNT_AUDIO_X86)
+    if constexpr (has_simd_kernels<T>)
+    {
+        switch (level)
+        {
+            case simd_level::avx512:
+            {
+                return encode_pcm_int16_avx512(samples, data, count);
+            }
+            case simd_level::avx2:
+            {
+                return encode_pcm_int16_avx2(samples, data, count);
+            }
+            case simd_level::sse2:
+            {
+                return encode_pcm_int16_sse2(samples, data, count);
+            }
+            default:
+            {
+                break;
+            }
+        }
+    }
+#endif
+
+    encode_pcm_int16_scalar(samples, data, count);
+}
+
+/*!
+\brief Encodes samples in the range [-1, 1] as packed signed 24 bit PCM values
+\copydetails encode_pcm_uint8()
+
+SSE2 has no byte shuffle, so that level uses the scalar kernel for 24 bit data.
+*/
+template <typename T>
+void encode_pcm_int24(const T*   samples,
+                      std::byte* data,
+                      size_t     count,
+                      simd_level level = cpu_simd_level())
+{
+#if defined(TNT_AUDIO_X86)
+    if constexpr (has_simd_kernels<T>)
+    {
+        switch (level)
+        {
+            case simd_level::avx512:
+            {
+                return encode_pcm_int24_avx512(samples, data, count);
+            }
+            case simd_level::avx2:
+            {
+                return encode_pcm_int24_avx2(samples, data, count);
+            }
+            default:
+            {
+                break;
+            }
+        }
+    }
+#endif
+
+    encode_pcm_int24_scalar(samples, data, count);
+}
+
+/*!
+\brief Encodes samples in the range [-1, 1] as signed 32 bit PCM values
+\copydetails encode_pcm_uint8()
+*/
+template <typename T>
+void encode_pcm_int32(const T*   samples,
+                      std::byte* data,
+                      size_t     count,
+                      simd_level level = cpu_simd_level())
+{
+#if defined(TNT_AUDIO_X86)
+    if constexpr (has_simd_kernels<T>)
+    {
+        switch (level)
+        {
+            case simd_level::avx512:
+            {
+                return encode_pcm_int32_avx512(samples, data, count);
+            }
+            case simd_level::avx2:
+            {
+                return encode_pcm_int32_avx2(samples, data, count);
+            }
+            case simd_level::sse2:
+            {
+                return encode_pcm_int32_sse2(samples, data, count);
+            }
+            default:
+            {
+                break;
+            }
+        }
+    }
+#endif
+
+    encode_pcm_int32_scalar(samples, data, count);
+}
+
+/*!
+\brief Encodes samples as 32 bit IEEE float values
+\param[in] samples Input samples
+\param[out] data Packed little endian float data
+\param[in] count Number of samples to encode
+\param[in] level Widest instruction set the kernel may use
+*/
+template <typename T>
+void encode_ieee_float32(const T*   samples,
+                         std::byte* data,
+                         size_t     count,
+                         simd_level level = cpu_simd_level())
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        // Empty buffers may have null pointers, which memcpy must not be given even for no bytes
+        if (count > 0)
+        {
+            std::memcpy(data, samples, count * sizeof(float));
+        }
+
+        return;
+    }
+#if defined(TNT_AUDIO_X86)
+    else if constexpr (std::is_same_v<T, double>)
+    {
+        switch (level)
+        {
+            case simd_level::avx512:
+            {
+                return encode_ieee_float32_avx512(samples, data, count);
+            }
+            case simd_level::avx2:
+            {
+                return encode_ieee_float32_avx2(samples, data, count);
+            }
+            case simd_level::sse2:
+            {
+                return encode_ieee_float32_sse2(samples, data, count);
+            }
+            default:
+            {
+                break;
+            }
+        }
+    }
+#endif
+
+    encode_ieee_float32_scalar(samples, data, count);
+}
+
+/*!
+\brief Encodes samples as 64 bit IEEE float values
+\param[in] samples Input samples
+\param[out] data Packed little endian double data
+\param[in] count Number of samples to encode
+*/
+template <typename T>
+void encode_ieee_float64(const T* samples, std::byte* data, size_t count)
+{
+    if constexpr (std::is_same_v<T, double>)
+    {
+        if (count > 0)
+        {
+            std::memcpy(data, samples, count * sizeof(double));
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const auto value = static_cast<double>(samples[i]);
+            std::memcpy(data + i * sizeof(value), &value, sizeof(value));
+        }
+    }
+}
+
+}  // namespace tnt::audio::detail
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+#if defined(_WIN32)
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#    endif
+#    include <windows.h>
+#else
+#    include <cerrno>
+#    include <fcntl.h>
+#    include <unistd.h>
+#endif
+
+namespace tnt::audio::detail
+{
+
+/*!
+\brief Read only handle to a file that reads at explicit offsets
+
+Reads don't share a file position, so any number of threads can read from the same handle at once.
+The file may be rewritten while the handle is open, reads then see the new contents.
+*/
+class file_handle final
+{
+public:
+    /*!
+    \brief Constructor
+    \param[in] path Path to the file to open (check is_open() for success)
+    */
+    explicit file_handle(const std::filesystem::path& path)
+    {
+#if defined(_WIN32)
+        m_handle = CreateFileW(path.c_str(),
+                               GENERIC_READ,
+                               FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                               nullptr,
+                               OPEN_EXISTING,
+                               FILE_ATTRIBUTE_NORMAL,
+                               nullptr);
+#else
+        m_handle = ::open(path.c_str(), O_RDONLY);
+#endif
+    }
+
+    file_handle(const file_handle&) = delete;
+
+    file_handle& operator=(const file_handle&) = delete;
+
+    /*!
+    \brief Destructor
+    */
+    ~file_handle()
+    {
+        if (this->is_open())
+        {
+#if defined(_WIN32)
+            CloseHandle(m_handle);
+#else
+            ::close(m_handle);
+#endif
+        }
+    }
+
+    /*!
+    \brief Checks whether the file was opened
+    \return True if the file is open
+    */
+    bool is_open() const
+    {
+#if defined(_WIN32)
+        return m_handle != INVALID_HANDLE_VALUE;
+#else
+        return m_handle >= 0;
+#endif
+    }
+
+    /*!
+    \brief Reads bytes starting at an offset into the file
+    \param[in] offset Offset of the first byte to read
+    \param[out] data Buffer to read into
+    \param[in] size Number of bytes to read
+    \return True if all of the bytes were read
+    */
+    bool read_at(size_t offset, std::byte* data, size_t size) const
+    {
+        return this->read_some_at(offset, data, size) == size;
+    }
+
+    /*!
+    \brief Reads bytes starting at an offset into the file, stopping early at the end of the file
+    \param[in] offset Offset of the first byte to read
+    \param[out] data Buffer to read into
+    \param[in] size Maximum number of bytes to read
+    \return Number of bytes read
+    */
+    size_t read_some_at(size_t offset, std::byte* data, size_t size) const
+    {
+        size_t total{};
+        while (size > 0)
+        {
+#if defined(_WIN32)
+            // ReadFile takes a 32 bit size, so read large requests in pieces
+            const auto request = static_cast<DWORD>(std::min<size_t>(size, 1 << 30));
+
+            OVERLAPPED overlapped{};
+            overlapped.Offset     = static_cast<DWORD>(offset);
+            overlapped.OffsetHigh = static_cast<DWORD>(static_cast<uint64_t>(offset) >> 32);
+
+            DWORD count{};
+            if (!ReadFile(m_handle, data, request, &count, &overlapped) || count == 0)
+            {
+                break;
+            }
+#else
+            const auto count = ::pread(m_handle, data, size, static_cast<off_t>(offset));
+            if (count < 0 && errno == EINTR)
+            {
+                continue;
+            }
+
+            if (count <= 0)
+            {
+                break;
+            }
+#endif
+            offset += static_cast<size_t>(count);
+            data += count;
+            size -= static_cast<size_t>(count);
+            total += static_cast<size_t>(count);
+        }
+
+        return total;
+    }
+
+private:
+#if defined(_WIN32)
+    HANDLE m_handle;
+#else
+    int m_handle;
+#endif
+};
+
+}  // namespace tnt::audio::detail
@@ -0,0 +1,197 @@
+#pragma once
+
+#include "../multisignal.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace tnt::audio::detail
+{
+
+// Wave data is stored one frame after another, while a multisignal is addressed per channel. The
+// transpose between the two is done a tile at a time so the interleaved rows and the channel
+// samples being touched both stay in cache, which matters once files have dozens of channels.
+inline constexpr size_t tile_frames   = 64;
+inline constexpr size_t tile_channels = 16;
+
+// Transposes interleaved samples with a channel count known at compile time, so the inner loop
+// is fully unrolled and the compiler is free to vectorize it
+template <size_t Channels, typename T>
+void deinterleave_fixed(const T* samples, size_t frames, size_t offset, multisignal<T>& signal)
+{
+    for (size_t n = 0; n < frames; ++n, samples += Channels)
+    {
+        auto&& frame = signal[offset + n];
+        for (size_t c = 0; c < Channels; ++c)
+        {
+            frame[c] = samples[c];
+        }
+    }
+}
+
+template <size_t Channels, typename T>
+void interleave_fixed(const multisignal<T>& signal, size_t offset, size_t frames, T* samples)
+{
+    for (size_t n = 0; n < frames; ++n, samples += Channels)
+    {
+        auto&& frame = signal[offset + n];
+        for (size_t c = 0; c < Channels; ++c)
+        {
+            samples[c] = frame[c];
+        }
+    }
+}
+
+// Transposes any number of channels in tiles of frames by groups of channels. The source of channel
+// selection[c] is stored in channel c of the signal (no selection stores channels in order).
+template <typename T>
+void deinterleave_blocked(const T*                   samples,
+                          size_t                     frames,
+                          size_t                     channels,
+                          const std::vector<size_t>* selection,
+                          size_t                     offset,
+                          multisignal<T>&            signal)
+{
+    const auto selected = selection ? selection->size() : channels;
+    for (size_t n0 = 0; n0 < frames; n0 += tile_frames)
+    {
+        const auto n1 = std::min(frames, n0 + tile_frames);
+        for (size_t c0 = 0; c0 < selected; c0 += tile_channels)
+        {
+            const auto c1 = std::min(selected, c0 + tile_channels);
+            for (size_t n = n0; n < n1; ++n)
+            {
+                const auto* row   = samples + n * channels;
+                auto&&      frame = signal[offset + n];
+                if (selection)
+                {
+                    for (size_t c = c0; c < c1; ++c)
+                    {
+                        frame[c] = row[(*selection)[c]];
+                    }
+                }
+                else
+                {
+                    for (size_t c = c0; c < c1; ++c)
+                    {
+                        frame[c] = row[c];
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <typename T>
+void interleave_blocked(const multisignal<T>& signal, size_t offset, size_t frames, T* samples)
+{
+    const auto channels = signal.channels();
+    for (size_t n0 = 0; n0 < frames; n0 += tile_frames)
+    {
+        const auto n1 = std::min(frames, n0 + tile_frames);
+        for (size_t c0 = 0; c0 < channels; c0 += tile_channels)
+        {
+            const auto c1 = std::min(channels, c0 + tile_channels);
+            for (size_t n = n0; n < n1; ++n)
+            {
+                auto*  row   = samples + n * channels;
+                auto&& frame = signal[offset + n];
+                for (size_t c = c0; c < c1; ++c)
+                {
+                    row[c] = frame[c];
+                }
+            }
+        }
+    }
+}
+
+// Copies interleaved samples into the signal starting at the given frame offset
+template <typename T>
+void deinterleave(const T* samples, size_t frames, size_t offset, multisignal<T>& signal)
+{
+    switch (signal.channels())
+    {
+        case 1:
+        {
+            return deinterleave_fixed<1>(samples, frames, offset, signal);
+        }
+        case 2:
+        {
+            return deinterleave_fixed<2>(samples, frames, offset, signal);
+        }
+        case 6:
+        {
+            return deinterleave_fixed<6>(samples, frames, offset, signal);
+        }
+        case 8:
+        {
+            return deinterleave_fixed<8>(samples, frames, offset, signal);
+        }
+        default:
+        {
+            const auto channels = signal.channels();
+            return deinterleave_blocked(samples, frames, channels, nullptr, offset, signal);
+        }
+    }
+}
+
+// Copies the selected channels of interleaved samples into the signal starting at the given frame
+// offset
+template <typename T>
+void deinterleave(const T*                   samples,
+                  size_t                     frames,
+                  size_t                     channels,
+                  const std::vector<size_t>& selection,
+                  size_t                     offset,
+                  multisignal<T>&            signal)
+{
+    deinterleave_blocked(samples, frames, channels, &selection, offset, signal);
+}
+
+// Copies samples stored one channel after another (frames samples each) into the signal starting
+// at the given frame offset
+template <typename T>
+void deplanarize(const T* samples, size_t frames, size_t offset, multisignal<T>& signal)
+{
+    const auto channels = signal.channels();
+    for (size_t n = 0; n < frames; ++n)
+    {
+        auto&& frame = signal[offset + n];
+        for (size_t c = 0; c < channels; ++c)
+        {
+            frame[c] = samples[c * frames + n];
+        }
+    }
+}
+
+// Copies frames of the signal starting at the given frame offset into interleaved samples
+template <typename T>
+void interleave(const multisignal<T>& signal, size_t offset, size_t frames, T* samples)
+{
+    switch (signal.channels())
+    {
+        case 1:
+        {
+            return interleave_fixed<1>(signal, offset, frames, samples);
+        }
+        case 2:
+        {
+            return interleave_fixed<2>(signal, offset, frames, samples);
+        }
+        case 6:
+        {
+            return interleave_fixed<6>(signal, offset, frames, samples);
+        }
+        case 8:
+        {
+            return interleave_fixed<8>(signal, offset, frames, samples);
+        }
+        default:
+        {
+            return interleave_blocked(signal, offset, frames, samples);
+        }
+    }
+}
+
+}  // namespace tnt::audio::detail
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <stdexcept>
+#include <utility>
+
+#if defined(_WIN32)
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#    endif
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace tnt::audio::detail
+{
+
+/*!
+\brief Read only memory mapping of an entire file
+
+The mapping is shared, so every process mapping the same file reads from the same pages of the page
+cache. Memory that already holds the contents of a file can be wrapped instead of mapped.
+*/
+class mapped_file final
+{
+public:
+    /*!
+    \brief Constructor
+    \param[in] path Path to the file to map
+    */
+    explicit mapped_file(const std::filesystem::path& path)
+        : m_data()
+        , m_size()
+        , m_owned(true)
+    {
+#if defined(_WIN32)
+        const auto file = CreateFileW(path.c_str(),
+                                      GENERIC_READ,
+                                      FILE_SHARE_READ,
+                                      nullptr,
+                                      OPEN_EXISTING,
+                                      FILE_ATTRIBUTE_NORMAL,
+                                      nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            throw std::runtime_error("Failed to open '" + path.string() + "' for mapping");
+        }
+
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(file, &size))
+        {
+            CloseHandle(file);
+            throw std::runtime_error("Failed to get the size of '" + path.string() + "'");
+        }
+
+        m_size = static_cast<size_t>(size.QuadPart);
+        if (m_size == 0)
+        {
+            CloseHandle(file);
+            return;
+        }
+
+        const auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mapping)
+        {
+            throw std::runtime_error("Failed to map '" + path.string() + "'");
+        }
+
+        m_data = static_cast<const std::byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        CloseHandle(mapping);
+        if (!m_data)
+        {
+            throw std::runtime_error("Failed to map '" + path.string() + "'");
+        }
+#else
+        const auto file = ::open(path.c_str(), O_RDONLY);
+        if (file < 0)
+        {
+            throw std::runtime_error("Failed to open '" + path.string() + "' for mapping");
+        }
+
+        struct stat status
+        {
+        };
+        if (::fstat(file, &status) != 0)
+        {
+            ::close(file);
+            throw std::runtime_error("Failed to get the size of '" + path.string() + "'");
+        }
+
+        // Empty files can't be mapped
+        m_size = static_cast<size_t>(status.st_size);
+        if (m_size == 0)
+        {
+            ::close(file);
+            return;
+        }
+
+        // The mapping stays valid after the descriptor is closed
+        auto* data = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, file, 0);
+        ::close(file);
+        if (data == MAP_FAILED)
+        {
+            throw std::runtime_error("Failed to map '" + path.string() + "'");
+        }
+
+        m_data = static_cast<const std::byte*>(data);
+#endif
+    }
+
+    /*!
+    \brief Constructor (wraps memory owned by the caller, which must outlive the object)
+    \param[in] data Pointer to the first byte of the contents
+    \param[in] size Size of the contents in bytes
+    */
+    mapped_file(const std::byte* data, size_t size)
+        : m_data(data)
+        , m_size(size)
+        , m_owned(false)
+    {}
+
+    mapped_file(const mapped_file&) = delete;
+
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    /*!
+    \brief Destructor
+    */
+    ~mapped_file()
+    {
+        if (m_owned && m_data)
+        {
+#if defined(_WIN32)
+            UnmapViewOfFile(m_data);
+#else
+            ::munmap(const_cast<std::byte*>(m_data), m_size);
+#endif
+        }
+    }
+
+    /*!
+    \brief Gets the mapped contents of the file
+    \return Pointer to the first byte of the file (null for an empty file)
+    */
+    const std::byte* data() const
+    {
+        return m_data;
+    }
+
+    /*!
+    \brief Gets the size of the mapped file in bytes
+    \return Size
+    */
+    size_t size() const
+    {
+        return m_size;
+    }
+
+private:
+    const std::byte* m_data;
+    size_t           m_size;
+    bool             m_owned;
+};
+
+}  // namespace tnt::audio::detail
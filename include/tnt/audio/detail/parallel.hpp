@@ -0,0 +1,83 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace tnt::audio::detail
+{
+
+// Gets the number of threads to use for a requested thread count (zero means one per hardware
+// thread)
+inline size_t thread_count(size_t threads)
+{
+    if (threads == 0)
+    {
+        threads = std::thread::hardware_concurrency();
+    }
+
+    return std::max<size_t>(threads, 1);
+}
+
+// Calls task(i) for every i in [0, count) spread over up to the given number of threads, including
+// the calling thread. The first exception thrown by a task is rethrown once every thread finishes.
+template <typename Task>
+void parallel_for(size_t count, size_t threads, const Task& task)
+{
+    threads = std::min(thread_count(threads), count);
+    if (threads <= 1)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            task(i);
+        }
+
+        return;
+    }
+
+    // Tasks are handed out one at a time so uneven tasks don't leave threads idle
+    std::atomic<size_t>             next{};
+    std::vector<std::exception_ptr> errors(threads);
+
+    const auto worker = [&](size_t thread) {
+        try
+        {
+            for (auto i = next++; i < count; i = next++)
+            {
+                task(i);
+            }
+        }
+        catch (...)
+        {
+            errors[thread] = std::current_exception();
+            next           = count;
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (size_t thread = 1; thread < threads; ++thread)
+    {
+        pool.emplace_back(worker, thread);
+    }
+
+    worker(0);
+
+    for (auto& thread : pool)
+    {
+        thread.join();
+    }
+
+    for (const auto& error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+}  // namespace tnt::audio::detail
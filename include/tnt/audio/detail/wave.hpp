@@ -0,0 +1,30 @@
+#pragma once
+
+#include "../sample_codec.hpp"
+#include "../wave_format.hpp"
+#include "interleave.hpp"
+#include "wave_header.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace tnt::audio::detail
+{
+
+// Size of the intermediate buffers used when reading or writing sample data
+inline constexpr size_t buffer_size = 1 << 20;
+
+inline size_t sample_size(const wave_subformat& subformat)
+{
+    return visit_sample_codec<double>(subformat, [](auto codec) {
+        return decltype(codec)::sample_size;
+    });
+}
+
+// Number of whole frames that fit in the intermediate buffer (always at least one)
+inline size_t block_frames(size_t block_align)
+{
+    return std::max<size_t>(1, buffer_size / block_align);
+}
+
+}  // namespace tnt::audio::detail
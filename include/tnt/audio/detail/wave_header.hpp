@@ -0,0 +1,503 @@
+#pragma once
+
+#include "../trace.hpp"
+#include "../wave_format.hpp"
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace tnt::audio::detail
+{
+
+// Do NOT allow padding of the structures used for reading data
+#pragma pack(push, 1)
+struct header
+{
+    char     id[4];
+    uint32_t size;
+};
+
+struct format_chunk
+{
+    uint16_t format;
+    uint16_t channels;
+    uint32_t sample_rate;
+    uint32_t byte_rate;
+    uint16_t block_align;
+};
+
+struct format_ext_pcm
+{
+    uint16_t bits_per_sample;
+};
+
+struct format_ext_ieee_float
+{
+    uint16_t bits_per_sample;
+
+    // The internet suggests this extra field should exist, but in practice it is sometimes
+    // missing
+    // uint16_t extension_size;
+};
+
+// Rest of a WAVE_FORMAT_EXTENSIBLE fmt chunk after the bits per sample
+struct format_ext_extensible
+{
+    uint16_t extension_size;
+    uint16_t valid_bits_per_sample;
+    uint32_t channel_mask;
+
+    // The first two bytes of the subformat GUID are the format code of the samples
+    uint16_t subformat;
+    uint8_t  guid[14];
+};
+
+// Format code of a fmt chunk that stores the real format code in its extension
+inline constexpr uint16_t format_extensible = 0xFFFE;
+
+// 64 bit sizes of an RF64/BW64 file, which set the 32 bit sizes they replace to 0xFFFFFFFF
+struct ds64_chunk
+{
+    uint64_t riff_size;
+    uint64_t data_size;
+    uint64_t sample_count;
+    uint32_t table_length;
+};
+#pragma pack(pop)
+
+// Value of a 32 bit size field whose real value is stored in the ds64 chunk
+inline constexpr uint32_t rf64_size = 0xFFFFFFFF;
+
+// Location and shape of the sample data in a wave file
+struct wave_layout
+{
+    wave_subformat subformat;
+    size_t         sample_rate;
+    size_t         channels;
+    size_t         size;
+    size_t         data_position;
+
+    // Speaker positions of the channels from WAVE_FORMAT_EXTENSIBLE (zero if not specified)
+    uint32_t channel_mask;
+};
+
+// Everything in a wave file before the sample data
+struct wave_header
+{
+    std::vector<std::byte> bytes;
+
+    // Offsets of the size fields that depend on the amount of sample data
+    size_t riff_size_position;
+    size_t data_size_position;
+
+    // Offset of the chunk reserved for 64 bit sizes (a JUNK chunk until it is needed)
+    size_t ds64_position;
+
+    size_t block_align;
+};
+
+/*!
+\brief Fills in the sizes of a header that depend on the amount of sample data
+
+The header is switched to RF64 when the sizes don't fit in the 32 bit fields of a RIFF file, and
+back to RIFF when they do.
+
+\param[in,out] wave Header to update
+\param[in] data_size Size of the sample data in bytes
+*/
+inline void set_data_size(wave_header& wave, uint64_t data_size)
+{
+    const auto riff_size = wave.bytes.size() - wave.riff_size_position - sizeof(uint32_t)
+                         + data_size;
+    const auto large = riff_size > std::numeric_limits<uint32_t>::max();
+
+    ds64_chunk ds64{};
+    if (large)
+    {
+        ds64.riff_size    = riff_size;
+        ds64.data_size    = data_size;
+        ds64.sample_count = wave.block_align ? data_size / wave.block_align : 0;
+    }
+
+    const auto riff_size32 = large ? rf64_size : static_cast<uint32_t>(riff_size);
+    const auto data_size32 = large ? rf64_size : static_cast<uint32_t>(data_size);
+
+    auto* bytes = wave.bytes.data();
+    std::memcpy(bytes, large ? "RF64" : "RIFF", sizeof(header::id));
+    std::memcpy(bytes + wave.riff_size_position, &riff_size32, sizeof(riff_size32));
+    std::memcpy(bytes + wave.ds64_position, large ? "ds64" : "JUNK", sizeof(header::id));
+    std::memcpy(bytes + wave.ds64_position + sizeof(header), &ds64, sizeof(ds64));
+    std::memcpy(bytes + wave.data_size_position, &data_size32, sizeof(data_size32));
+}
+
+/*!
+\brief Builds the header of a wave file
+\param[in] path Path to the wave file (only used for error messages)
+\param[in] format Format to write the wave file in
+\param[in] subformat Subformat indicating the data type to store the data in
+\param[in] sample_rate Sample rate of the audio data
+\param[in] channels Number of channels of audio data
+\param[in] data_size Size of the sample data in bytes
+\return Header
+*/
+inline wave_header make_header(const std::filesystem::path& path,
+                               const wave_format&           format,
+                               const wave_subformat&        subformat,
+                               size_t                       sample_rate,
+                               size_t                       channels,
+                               size_t                       data_size)
+{
+    header riff_header{};
+    std::string("RIFF").copy(riff_header.id, sizeof(riff_header.id));
+
+    char wave[4]{};
+    std::string("WAVE").copy(wave, sizeof(wave));
+
+    header format_header{};
+    std::string("fmt ").copy(format_header.id, sizeof(format_header.id));
+
+    format_chunk format_chunk{};
+    format_chunk.format      = static_cast<uint16_t>(format);
+    format_chunk.channels    = static_cast<uint16_t>(channels);
+    format_chunk.sample_rate = static_cast<uint32_t>(sample_rate);
+
+    std::vector<std::byte> format_ext_buffer;
+
+    switch (format)
+    {
+        case wave_format::pcm:
+        {
+            format_ext_pcm format_ext{};
+            format_ext_buffer.resize(sizeof(format_ext));
+
+            switch (subformat)
+            {
+                case wave_subformat::pcm_uint8:
+                {
+                    format_ext.bits_per_sample = 8;
+                    break;
+                }
+                case wave_subformat::pcm_int16:
+                {
+                    format_ext.bits_per_sample = 16;
+                    break;
+                }
+                case wave_subformat::pcm_int24:
+                {
+                    format_ext.bits_per_sample = 24;
+                    break;
+                }
+                case wave_subformat::pcm_int32:
+                {
+                    format_ext.bits_per_sample = 32;
+                    break;
+                }
+                default:
+                {
+                    throw std::runtime_error("Invalid subformat for wave_file '"
+                                             + path.string() + "'");
+                    break;
+                }
+            }
+
+            format_chunk.byte_rate = format_chunk.sample_rate * format_ext.bits_per_sample
+                                   * format_chunk.channels / CHAR_BIT;
+            format_chunk.block_align = format_ext.bits_per_sample * format_chunk.channels
+                                     / CHAR_BIT;
+            std::memcpy(format_ext_buffer.data(), &format_ext, format_ext_buffer.size());
+            break;
+        }
+        case wave_format::ieee_float:
+        {
+            format_ext_ieee_float format_ext{};
+            format_ext_buffer.resize(sizeof(format_ext));
+
+            switch (subformat)
+            {
+                case wave_subformat::ieee_float32:
+                {
+                    format_ext.bits_per_sample = 32;
+                    break;
+                }
+                case wave_subformat::ieee_float64:
+                {
+                    format_ext.bits_per_sample = 64;
+                    break;
+                }
+                default:
+                {
+                    throw std::runtime_error("Invalid subformat for wave_file '"
+                                             + path.string() + "'");
+                    break;
+                }
+            }
+
+            format_chunk.byte_rate = format_chunk.sample_rate * format_ext.bits_per_sample
+                                   * format_chunk.channels / CHAR_BIT;
+            format_chunk.block_align = format_ext.bits_per_sample * format_chunk.channels
+                                     / CHAR_BIT;
+            std::memcpy(format_ext_buffer.data(), &format_ext, format_ext_buffer.size());
+            break;
+        }
+        default:
+        {
+            std::stringstream format_stream;
+            format_stream << std::hex << static_cast<size_t>(format);
+            throw std::runtime_error("Invalid format '" + format_stream.str()
+                                     + "' for wave_file '" + path.string() + "'");
+        }
+    }
+
+    format_header.size = static_cast<uint32_t>(sizeof(format_chunk) + format_ext_buffer.size());
+
+    // Space for 64 bit sizes is always reserved, so a file can become RF64 once its final size is
+    // known without moving the sample data
+    header ds64_header{};
+    std::string("JUNK").copy(ds64_header.id, sizeof(ds64_header.id));
+    ds64_header.size = sizeof(ds64_chunk);
+
+    header data_header{};
+    std::string("data").copy(data_header.id, sizeof(data_header.id));
+
+    wave_header result{};
+    result.block_align = format_chunk.block_align;
+
+    const auto append = [&result](const void* data, size_t size) {
+        const auto* bytes = static_cast<const std::byte*>(data);
+        result.bytes.insert(result.bytes.end(), bytes, bytes + size);
+    };
+
+    append(&riff_header, sizeof(riff_header));
+    append(wave, sizeof(wave));
+
+    result.ds64_position = result.bytes.size();
+    const ds64_chunk ds64{};
+    append(&ds64_header, sizeof(ds64_header));
+    append(&ds64, sizeof(ds64));
+
+    append(&format_header, sizeof(format_header));
+    append(&format_chunk, sizeof(format_chunk));
+    append(format_ext_buffer.data(), format_ext_buffer.size());
+    append(&data_header, sizeof(data_header));
+
+    result.riff_size_position = sizeof(riff_header.id);
+    result.data_size_position = result.bytes.size() - sizeof(data_header.size);
+
+    set_data_size(result, data_size);
+    return result;
+}
+
+// Parses the contents of a fmt chunk into the layout and returns the size of a frame
+template <typename Next>
+size_t parse_format(const std::filesystem::path& path, const Next& next, wave_layout& layout)
+{
+    format_chunk format_chunk{};
+    if (!next(&format_chunk, sizeof(format_chunk)) || format_chunk.channels == 0
+        || format_chunk.block_align == 0)
+    {
+        throw std::runtime_error("Error reading format chunk for wave_file '" + path.string()
+                                 + "'");
+    }
+
+    layout.sample_rate = format_chunk.sample_rate;
+    layout.channels    = format_chunk.channels;
+
+    // Every supported format extension starts with the bits per sample
+    uint16_t bits_per_sample{};
+    if (!next(&bits_per_sample, sizeof(bits_per_sample)))
+    {
+        throw std::runtime_error("Error reading format extension for wave_file '" + path.string()
+                                 + "'");
+    }
+
+    auto format = format_chunk.format;
+    if (format == format_extensible)
+    {
+        format_ext_extensible format_ext{};
+        if (!next(&format_ext, sizeof(format_ext)))
+        {
+            throw std::runtime_error("Error reading extensible format extension for wave_file '"
+                                     + path.string() + "'");
+        }
+
+        layout.channel_mask = format_ext.channel_mask;
+        format              = format_ext.subformat;
+    }
+
+    switch (static_cast<wave_format>(format))
+    {
+        case wave_format::pcm:
+        {
+            switch (bits_per_sample)
+            {
+                case 8:
+                {
+                    layout.subformat = wave_subformat::pcm_uint8;
+                    break;
+                }
+                case 16:
+                {
+                    layout.subformat = wave_subformat::pcm_int16;
+                    break;
+                }
+                case 24:
+                {
+                    layout.subformat = wave_subformat::pcm_int24;
+                    break;
+                }
+                case 32:
+                {
+                    layout.subformat = wave_subformat::pcm_int32;
+                    break;
+                }
+                default:
+                {
+                    throw std::runtime_error("Invalid PCM subformat for wave_file '"
+                                             + path.string() + "'");
+                }
+            }
+
+            break;
+        }
+        case wave_format::ieee_float:
+        {
+            switch (bits_per_sample)
+            {
+                case 32:
+                {
+                    layout.subformat = wave_subformat::ieee_float32;
+                    break;
+                }
+                case 64:
+                {
+                    layout.subformat = wave_subformat::ieee_float64;
+                    break;
+                }
+                default:
+                {
+                    throw std::runtime_error("Invalid IEEE float subformat for wave_file '"
+                                             + path.string() + "'");
+                }
+            }
+
+            break;
+        }
+        default:
+        {
+            std::stringstream format_stream;
+            format_stream << std::hex << format;
+            throw std::runtime_error("Invalid format '" + format_stream.str() + "' for wave_file '"
+                                     + path.string() + "'");
+        }
+    }
+
+    // Frames are read and decoded as channels * sample size bytes, so padded frames would count
+    // frames with one size and decode them with another
+    if (format_chunk.block_align != format_chunk.channels * (bits_per_sample / 8))
+    {
+        throw std::runtime_error("Invalid block align for wave_file '" + path.string() + "'");
+    }
+
+    return format_chunk.block_align;
+}
+
+/*!
+\brief Parses the header of a wave file up to the start of the sample data
+\param[in] path Path to the wave file (only used for error messages)
+\param[in] read Reads bytes at an offset into the file, like file_handle::read_at()
+\return Location and shape of the sample data
+*/
+template <typename Read>
+wave_layout parse_header(const std::filesystem::path& path, const Read& read)
+{
+    size_t     position{};
+    const auto next = [&](void* data, size_t size) {
+        const auto success = read(position, static_cast<std::byte*>(data), size);
+        position += size;
+        return success;
+    };
+
+    // RF64 and BW64 files have the same layout as RIFF files, with 64 bit sizes in a ds64 chunk
+    header riff_header{};
+    if (!next(&riff_header, sizeof(riff_header))
+        || (std::strncmp(riff_header.id, "RIFF", sizeof(riff_header.id))
+            && std::strncmp(riff_header.id, "RF64", sizeof(riff_header.id))
+            && std::strncmp(riff_header.id, "BW64", sizeof(riff_header.id))))
+    {
+        throw std::runtime_error("Invalid RIFF header for wave_file '" + path.string() + "'");
+    }
+
+    char wave[4]{};
+    if (!next(wave, sizeof(wave)) || std::strncmp(wave, "WAVE", sizeof(wave)))
+    {
+        throw std::runtime_error("Invalid RIFF format for wave_file '" + path.string() + "'");
+    }
+
+    wave_layout layout{};
+    size_t      block_align{};
+    bool        has_format{};
+    ds64_chunk  ds64{};
+
+    // Walk the chunks until the start of the data chunk
+    const scoped_trace trace("walk_chunks");
+    for (;;)
+    {
+        header current_header{};
+        if (!next(&current_header, sizeof(current_header)))
+        {
+            throw std::runtime_error("Failed to find data chunk in wave_file '" + path.string()
+                                     + "'");
+        }
+
+        // Chunks are padded to an even size
+        const auto chunk_end = position + current_header.size + (current_header.size & 1);
+
+        if (!std::strncmp(current_header.id, "ds64", sizeof(current_header.id)))
+        {
+            if (current_header.size < sizeof(ds64) || !next(&ds64, sizeof(ds64)))
+            {
+                throw std::runtime_error("Invalid ds64 chunk for wave_file '" + path.string()
+                                         + "'");
+            }
+        }
+        else if (!std::strncmp(current_header.id, "fmt ", sizeof(current_header.id)))
+        {
+            block_align = parse_format(path, next, layout);
+            has_format  = true;
+
+            if (position > chunk_end)
+            {
+                throw std::runtime_error("Unexpected fmt chunk size for wave_file '"
+                                         + path.string() + "'");
+            }
+        }
+        else if (!std::strncmp(current_header.id, "data", sizeof(current_header.id)))
+        {
+            if (!has_format)
+            {
+                throw std::runtime_error("Invalid fmt header for wave_file '" + path.string()
+                                         + "'");
+            }
+
+            const auto data_size = current_header.size == rf64_size && ds64.data_size
+                                     ? ds64.data_size
+                                     : current_header.size;
+
+            layout.data_position = position;
+            layout.size          = static_cast<size_t>(data_size / block_align);
+            return layout;
+        }
+
+        position = chunk_end;
+    }
+}
+
+}  // namespace tnt::audio::detail
@@ -1,7 +1,11 @@
 #pragma once
 
+#include "file_stats.hpp"
 #include "multisignal.hpp"
 
+#include <cstddef>
+#include <vector>
+
 namespace tnt::audio
 {
 
@@ -21,25 +25,25 @@ public:
     \brief Gets the duration of the audio file in seconds
     \return Duration
     */
-    virtual double duration() = 0;
+    virtual double duration() const = 0;
 
     /*!
     \brief Gets the sample rate of the encoded audio data
     \return Sample Rate
     */
-    virtual size_t sample_rate() = 0;
+    virtual size_t sample_rate() const = 0;
 
     /*!
     \brief Gets the number of samples in a single channel of the contained audio data
     \return Size
     */
-    virtual size_t size() = 0;
+    virtual size_t size() const = 0;
 
     /*!
     \brief Gets the number of channels contained in the audio file
     \return Channels
     */
-    virtual size_t channels() = 0;
+    virtual size_t channels() const = 0;
 
     /*!
     \brief Reads the audio data from the file
@@ -47,11 +51,103 @@ public:
     */
     virtual multisignal<T> read() = 0;
 
+    /*!
+    \brief Reads a range of frames of the audio data from the file
+    \param[in] start_frame Index of the first frame to read
+    \param[in] frame_count Number of frames to read (clamped to the end of the file)
+    \return Multi-channel signal containing the audio data
+    */
+    virtual multisignal<T> read(size_t start_frame, size_t frame_count) = 0;
+
+    /*!
+    \brief Reads a range of frames of a subset of the channels of the audio data from the file
+    \param[in] start_frame Index of the first frame to read
+    \param[in] frame_count Number of frames to read (clamped to the end of the file)
+    \param[in] channels Indices of the channels to read, in the order they should be returned
+    \return Multi-channel signal containing the audio data
+    */
+    virtual multisignal<T> read(size_t                     start_frame,
+                                size_t                     frame_count,
+                                const std::vector<size_t>& channels) = 0;
+
+    /*!
+    \brief Reads the audio data from the file into an existing signal
+
+    The storage of the signal is reused when it already has the sample rate, size and number of
+    channels of the audio data, so reading many files of the same shape doesn't allocate.
+
+    \param[in,out] signal Multi-channel signal to store the audio data in
+    \return Number of frames read
+    */
+    virtual size_t read_into(multisignal<T>& signal) = 0;
+
+    /*!
+    \brief Reads a range of frames of the audio data from the file into an existing signal
+    \param[in,out] signal Multi-channel signal to store the audio data in (reused when it already
+    has the shape of the range)
+    \param[in] start_frame Index of the first frame to read
+    \param[in] frame_count Number of frames to read (clamped to the end of the file)
+    \return Number of frames read
+    */
+    virtual size_t read_into(multisignal<T>& signal, size_t start_frame, size_t frame_count) = 0;
+
+    /*!
+    \brief Reads a range of frames of the audio data from the file without modifying the file
+    object
+
+    Any number of threads can call this at once on the same file object, for example to read
+    different segments of one long recording, as long as nothing else modifies the object
+    meanwhile.
+
+    \param[in] start_frame Index of the first frame to read
+    \param[in] frame_count Number of frames to read (clamped to the end of the file)
+    \return Multi-channel signal containing the audio data
+    */
+    virtual multisignal<T> read_at(size_t start_frame, size_t frame_count) const = 0;
+
+    /*!
+    \brief Reads a range of frames of the audio data from the file into an existing signal without
+    modifying the file object
+
+    Any number of threads can call this at once on the same file object, each with its own signal.
+
+    \param[in,out] signal Multi-channel signal to store the audio data in (reused when it already
+    has the shape of the range)
+    \param[in] start_frame Index of the first frame to read
+    \param[in] frame_count Number of frames to read (clamped to the end of the file)
+    \return Number of frames read
+    */
+    virtual size_t read_at(multisignal<T>& signal,
+                           size_t          start_frame,
+                           size_t          frame_count) const = 0;
+
     /*!
     \brief Writes audio data to the file
     \param[in] signal Multi-channel signal containing audio data to write to the file
     */
     virtual void write(const multisignal<T>& signal) = 0;
+
+    /*!
+    \brief Starts or stops counting the work done by this file object
+
+    Enabling starts the counts from the time spent opening the file, disabling stops all counting
+    and timing. Readers and writers opened while enabled count into the same stats.
+
+    \param[in] enabled Whether to count
+    */
+    virtual void enable_stats(bool enabled) = 0;
+
+    /*!
+    \brief Gets the work done since stats were enabled
+    \return Cumulative stats (all zero while disabled)
+    */
+    virtual file_stats stats() = 0;
+
+    /*!
+    \brief Gets the work done by the most recent read or write call
+    \return Stats of the last call (all zero while disabled)
+    */
+    virtual file_stats last_stats() = 0;
 };
 
 // Even abstract destructors need a definition
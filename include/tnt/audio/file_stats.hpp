@@ -0,0 +1,191 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace tnt::audio
+{
+
+/*!
+\brief Counts of the work done by a file object, used to tell whether storage, system calls or
+sample conversion limits throughput
+*/
+struct file_stats
+{
+    // Bytes of the file read or written (including bytes read through a memory mapping)
+    uint64_t bytes_read;
+    uint64_t bytes_written;
+
+    // Number of read and write calls made to the operating system
+    uint64_t read_calls;
+    uint64_t write_calls;
+
+    // Time spent parsing the header when the file was opened
+    std::chrono::nanoseconds header_time;
+
+    // Time spent in read and write calls
+    std::chrono::nanoseconds io_time;
+
+    // Time spent converting between encoded samples and samples of the signal
+    std::chrono::nanoseconds decode_time;
+    std::chrono::nanoseconds encode_time;
+
+    /*!
+    \brief Adds the counts of other stats to these
+    \param[in] other Stats to add
+    \return Reference to these stats
+    */
+    file_stats& operator+=(const file_stats& other)
+    {
+        bytes_read += other.bytes_read;
+        bytes_written += other.bytes_written;
+        read_calls += other.read_calls;
+        write_calls += other.write_calls;
+        header_time += other.header_time;
+        io_time += other.io_time;
+        decode_time += other.decode_time;
+        encode_time += other.encode_time;
+
+        return *this;
+    }
+
+    /*!
+    \brief Gets the counts accumulated since earlier stats were taken
+    \param[in] other Earlier stats
+    \return Difference of the stats
+    */
+    file_stats operator-(const file_stats& other) const
+    {
+        return {bytes_read - other.bytes_read,
+                bytes_written - other.bytes_written,
+                read_calls - other.read_calls,
+                write_calls - other.write_calls,
+                header_time - other.header_time,
+                io_time - other.io_time,
+                decode_time - other.decode_time,
+                encode_time - other.encode_time};
+    }
+};
+
+namespace detail
+{
+
+// Stats shared between a file and the readers and writers it creates, which may update them from
+// several threads at once. Stats are disabled by passing no counters, which skips the clock too.
+struct stats_counters
+{
+    std::atomic<uint64_t> bytes_read{};
+    std::atomic<uint64_t> bytes_written{};
+    std::atomic<uint64_t> read_calls{};
+    std::atomic<uint64_t> write_calls{};
+    std::atomic<int64_t>  header_time{};
+    std::atomic<int64_t>  io_time{};
+    std::atomic<int64_t>  decode_time{};
+    std::atomic<int64_t>  encode_time{};
+
+    file_stats snapshot() const
+    {
+        return {bytes_read.load(std::memory_order_relaxed),
+                bytes_written.load(std::memory_order_relaxed),
+                read_calls.load(std::memory_order_relaxed),
+                write_calls.load(std::memory_order_relaxed),
+                std::chrono::nanoseconds(header_time.load(std::memory_order_relaxed)),
+                std::chrono::nanoseconds(io_time.load(std::memory_order_relaxed)),
+                std::chrono::nanoseconds(decode_time.load(std::memory_order_relaxed)),
+                std::chrono::nanoseconds(encode_time.load(std::memory_order_relaxed))};
+    }
+
+    void add(const file_stats& stats)
+    {
+        bytes_read.fetch_add(stats.bytes_read, std::memory_order_relaxed);
+        bytes_written.fetch_add(stats.bytes_written, std::memory_order_relaxed);
+        read_calls.fetch_add(stats.read_calls, std::memory_order_relaxed);
+        write_calls.fetch_add(stats.write_calls, std::memory_order_relaxed);
+        header_time.fetch_add(stats.header_time.count(), std::memory_order_relaxed);
+        io_time.fetch_add(stats.io_time.count(), std::memory_order_relaxed);
+        decode_time.fetch_add(stats.decode_time.count(), std::memory_order_relaxed);
+        encode_time.fetch_add(stats.encode_time.count(), std::memory_order_relaxed);
+    }
+};
+
+inline void count_read(stats_counters* stats, uint64_t bytes, uint64_t calls = 1)
+{
+    if (stats)
+    {
+        stats->bytes_read.fetch_add(bytes, std::memory_order_relaxed);
+        stats->read_calls.fetch_add(calls, std::memory_order_relaxed);
+    }
+}
+
+inline void count_write(stats_counters* stats, uint64_t bytes, uint64_t calls = 1)
+{
+    if (stats)
+    {
+        stats->bytes_written.fetch_add(bytes, std::memory_order_relaxed);
+        stats->write_calls.fetch_add(calls, std::memory_order_relaxed);
+    }
+}
+
+// Adds the time until the end of the scope to one of the timers of the counters
+class scoped_time final
+{
+public:
+    scoped_time(stats_counters* stats, std::atomic<int64_t> stats_counters::*timer)
+        : m_timer(stats ? &(stats->*timer) : nullptr)
+        , m_start(m_timer ? clock::now() : clock::time_point{})
+    {
+    }
+
+    scoped_time(const scoped_time&) = delete;
+
+    scoped_time& operator=(const scoped_time&) = delete;
+
+    ~scoped_time()
+    {
+        if (m_timer)
+        {
+            const auto elapsed = std::chrono::nanoseconds(clock::now() - m_start);
+            m_timer->fetch_add(elapsed.count(), std::memory_order_relaxed);
+        }
+    }
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    std::atomic<int64_t>* m_timer;
+    clock::time_point     m_start;
+};
+
+// Stores the stats accumulated until the end of the scope (the work of one call) in a result
+class scoped_stats final
+{
+public:
+    scoped_stats(const stats_counters* stats, file_stats& result)
+        : m_stats(stats)
+        , m_result(result)
+        , m_start(stats ? stats->snapshot() : file_stats{})
+    {
+    }
+
+    scoped_stats(const scoped_stats&) = delete;
+
+    scoped_stats& operator=(const scoped_stats&) = delete;
+
+    ~scoped_stats()
+    {
+        if (m_stats)
+        {
+            m_result = m_stats->snapshot() - m_start;
+        }
+    }
+
+private:
+    const stats_counters* m_stats;
+    file_stats&           m_result;
+    file_stats            m_start;
+};
+
+}  // namespace detail
+
+}  // namespace tnt::audio
@@ -0,0 +1,330 @@
+#pragma once
+
+#include "detail/decode.hpp"
+#include "detail/encode.hpp"
+#include "wave_format.hpp"
+
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+namespace tnt::audio
+{
+
+/*!
+\brief Converts between samples of type T and the encoded samples of a wave subformat
+
+Every wave_subformat has a specialization, so the conversion is chosen at compile time and each
+(subformat, type) pair gets its own inlined kernels. Use visit_sample_codec() to choose a codec
+once from a subformat only known at run time.
+*/
+template <wave_subformat Subformat, typename T>
+struct sample_codec;
+
+/*!
+\brief Codec for unsigned 8 bit PCM
+*/
+template <typename T>
+struct sample_codec<wave_subformat::pcm_uint8, T>
+{
+    /*!
+    \brief Size of an encoded sample in bytes
+    */
+    static constexpr size_t sample_size = 1;
+
+    /*!
+    \brief Encoded value corresponding to a sample of 1 (relative to the midpoint)
+    */
+    static constexpr double full_scale = detail::pcm_uint8_range.scale;
+
+    /*!
+    \brief Decodes contiguous encoded samples
+    \param[in] data Encoded samples
+    \param[out] samples Decoded samples
+    \param[in] count Number of samples
+    */
+    static void decode(const std::byte* data, T* samples, size_t count)
+    {
+        detail::decode_pcm_uint8(data, samples, count);
+    }
+
+    /*!
+    \brief Decodes encoded samples spaced a fixed number of bytes apart (one channel of interleaved
+    frames)
+    \param[in] data First encoded sample
+    \param[in] stride Distance between consecutive encoded samples in bytes
+    \param[out] samples Decoded samples
+    \param[in] count Number of samples
+    */
+    static void decode_strided(const std::byte* data, size_t stride, T* samples, size_t count)
+    {
+        detail::decode_strided(data, stride, samples, count, detail::decode_pcm_uint8_scalar<T>);
+    }
+
+    /*!
+    \brief Encodes contiguous samples (clamped to the representable range)
+    \param[in] samples Samples to encode
+    \param[out] data Encoded samples
+    \param[in] count Number of samples
+    */
+    static void encode(const T* samples, std::byte* data, size_t count)
+    {
+        detail::encode_pcm_uint8(samples, data, count);
+    }
+};
+
+/*!
+\brief Codec for signed 16 bit PCM
+*/
+template <typename T>
+struct sample_codec<wave_subformat::pcm_int16, T>
+{
+    /*!
+    \brief Size of an encoded sample in bytes
+    */
+    static constexpr size_t sample_size = 2;
+
+    /*!
+    \brief Encoded value corresponding to a sample of 1
+    */
+    static constexpr double full_scale = detail::pcm_int16_range.scale;
+
+    /*!
+    \copydoc sample_codec<wave_subformat::pcm_uint8, T>::decode()
+    */
+    static void decode(const std::byte* data, T* samples, size_t count)
+    {
+        detail::decode_pcm_int16(data, samples, count);
+    }
+
+    /*!
+    \copydoc sample_codec<wave_subformat::pcm_uint8, T>::decode_strided()
+    */
+    static void decode_strided(const std::byte* data, size_t stride, T* samples, size_t count)
+    {
+        detail::decode_strided(data, stride, samples, count, detail::decode_pcm_int16_scalar<T>);
+    }
+
+    /*!
+    \copydoc sample_codec<wave_subformat::pcm_uint8, T>::encode()
+    */
+    static void encode(const T* samples, std::byte* data, size_t count)
+    {
+        detail::encode_pcm_int16(samples, data, count);
+    }
+};
+
+/*!
+\brief Codec for signed 24 bit PCM
+*/
+template <typename T>
+struct sample_codec<wave_subformat::pcm_int24, T>
+{
+    /*!
+    \brief Size of an encoded sample in bytes
+    */
+    static constexpr size_t sample_size = 3;
+
+    /*!
+    \brief Encoded value corresponding to a sample of 1
+    */
+    static constexpr double full_scale = detail::pcm_int24_range.scale;
+
+    /*!
+    \copydoc sample_codec<wave_subformat::pcm_uint8, T>::decode()
+    */
+    static void decode(const std::byte* data, T* samples, size_t count)
+    {
+        detail::decode_pcm_int24(data, samples, count);
+    }
+
+    /*!
+    \copydoc sample_codec<wave_subformat::pcm_uint8, T>::decode_strided()
+    */
+    static void decode_strided(const std::byte* data, size_t stride, T* samples, size_t count)
+    {
+        detail::decode_strided(data, stride, samples, count, detail::decode_pcm_int24_scalar<T>);
+    }
+
+    /*!
+    \copydoc sample_codec<wave_subformat::pcm_uint8, T>::encode()
+    */
+    static void encode(const T* samples, std::byte* data, size_t count)
+    {
+        detail::encode_pcm_int24(samples, data, count);
+    }
+};
+
+/*!
+\brief Codec for signed 32 bit PCM
+*/
+template <typename T>
+struct sample_codec<wave_subformat::pcm_int32, T>
+{
+    /*!
+    \brief Size of an encoded sample in bytes
+    */
+    static constexpr size_t sample_size = 4;
+
+    /*!
+    \brief Encoded value corresponding to a sample of 1
+    */
+    static constexpr double full_scale = detail::pcm_int32_range.scale;
+
+    /*!
+    \copydoc sample_codec<wave_subformat::pcm_uint8, T>::decode()
+    */
+    static void decode(const std::byte* data, T* samples, size_t count)
+    {
+        detail::decode_pcm_int32(data, samples, count);
+    }
+
+    /*!
+    \copydoc sample_codec<wave_subformat::pcm_uint8, T>::decode_strided()
+    */
+    static void decode_strided(const std::byte* data, size_t stride, T* samples, size_t count)
+    {
+        detail::decode_strided(data, stride, samples, count, detail::decode_pcm_int32_scalar<T>);
+    }
+
+    /*!
+    \copydoc sample_codec<wave_subformat::pcm_uint8, T>::encode()
+    */
+    static void encode(const T* samples, std::byte* data, size_t count)
+    {
+        detail::encode_pcm_int32(samples, data, count);
+    }
+};
+
+/*!
+\brief Codec for 32 bit IEEE floating point
+*/
+template <typename T>
+struct sample_codec<wave_subformat::ieee_float32, T>
+{
+    /*!
+    \brief Size of an encoded sample in bytes
+    */
+    static constexpr size_t sample_size = 4;
+
+    /*!
+    \brief Encoded value corresponding to a sample of 1
+    */
+    static constexpr double full_scale = 1;
+
+    /*!
+    \copydoc sample_codec<wave_subformat::pcm_uint8, T>::decode()
+    */
+    static void decode(const std::byte* data, T* samples, size_t count)
+    {
+        detail::decode_ieee_float32(data, samples, count);
+    }
+
+    /*!
+    \copydoc sample_codec<wave_subformat::pcm_uint8, T>::decode_strided()
+    */
+    static void decode_strided(const std::byte* data, size_t stride, T* samples, size_t count)
+    {
+        detail::decode_strided(data, stride, samples, count, detail::decode_ieee_float32<T>);
+    }
+
+    /*!
+    \brief Encodes contiguous samples
+    \param[in] samples Samples to encode
+    \param[out] data Encoded samples
+    \param[in] count Number of samples
+    */
+    static void encode(const T* samples, std::byte* data, size_t count)
+    {
+        detail::encode_ieee_float32(samples, data, count);
+    }
+};
+
+/*!
+\brief Codec for 64 bit IEEE floating point
+*/
+template <typename T>
+struct sample_codec<wave_subformat::ieee_float64, T>
+{
+    /*!
+    \brief Size of an encoded sample in bytes
+    */
+    static constexpr size_t sample_size = 8;
+
+    /*!
+    \brief Encoded value corresponding to a sample of 1
+    */
+    static constexpr double full_scale = 1;
+
+    /*!
+    \copydoc sample_codec<wave_subformat::pcm_uint8, T>::decode()
+    */
+    static void decode(const std::byte* data, T* samples, size_t count)
+    {
+        detail::decode_ieee_float64(data, samples, count);
+    }
+
+    /*!
+    \copydoc sample_codec<wave_subformat::pcm_uint8, T>::decode_strided()
+    */
+    static void decode_strided(const std::byte* data, size_t stride, T* samples, size_t count)
+    {
+        detail::decode_strided(data, stride, samples, count, detail::decode_ieee_float64<T>);
+    }
+
+    /*!
+    \copydoc sample_codec<wave_subformat::ieee_float32, T>::encode()
+    */
+    static void encode(const T* samples, std::byte* data, size_t count)
+    {
+        detail::encode_ieee_float64(samples, data, count);
+    }
+};
+
+/*!
+\brief Calls a function with the codec of a subformat that is only known at run time
+
+The codec is passed as a default constructed object, so a generic lambda can recover its type with
+decltype and run a whole loop with the conversion resolved at compile time.
+
+\param[in] subformat Subformat to select the codec of
+\param[in] visitor Function taking the codec
+\return Result of the function
+*/
+template <typename T, typename Visitor>
+decltype(auto) visit_sample_codec(const wave_subformat& subformat, Visitor&& visitor)
+{
+    switch (subformat)
+    {
+        case wave_subformat::pcm_uint8:
+        {
+            return std::forward<Visitor>(visitor)(sample_codec<wave_subformat::pcm_uint8, T>{});
+        }
+        case wave_subformat::pcm_int16:
+        {
+            return std::forward<Visitor>(visitor)(sample_codec<wave_subformat::pcm_int16, T>{});
+        }
+        case wave_subformat::pcm_int24:
+        {
+            return std::forward<Visitor>(visitor)(sample_codec<wave_subformat::pcm_int24, T>{});
+        }
+        case wave_subformat::pcm_int32:
+        {
+            return std::forward<Visitor>(visitor)(sample_codec<wave_subformat::pcm_int32, T>{});
+        }
+        case wave_subformat::ieee_float32:
+        {
+            return std::forward<Visitor>(visitor)(sample_codec<wave_subformat::ieee_float32, T>{});
+        }
+        case wave_subformat::ieee_float64:
+        {
+            return std::forward<Visitor>(visitor)(sample_codec<wave_subformat::ieee_float64, T>{});
+        }
+        default:
+        {
+            throw std::invalid_argument("Invalid wave_subformat");
+        }
+    }
+}
+
+}  // namespace tnt::audio
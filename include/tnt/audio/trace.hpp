@@ -0,0 +1,250 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace tnt::audio
+{
+
+namespace detail
+{
+
+// Collects trace events from every thread into one Chrome trace file
+class tracer final
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    static tracer& instance()
+    {
+        static tracer tracer;
+        return tracer;
+    }
+
+    tracer(const tracer&) = delete;
+
+    tracer& operator=(const tracer&) = delete;
+
+    ~tracer()
+    {
+        this->stop();
+    }
+
+    bool enabled() const
+    {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    void start(const std::filesystem::path& path)
+    {
+        std::lock_guard lock(m_mutex);
+        this->close();
+
+        m_file.open(path, std::ios::trunc);
+        if (!m_file.is_open())
+        {
+            throw std::runtime_error("Failed to open trace file '" + path.string() + "'");
+        }
+
+        // Timestamps are in microseconds, and the default precision of six significant digits
+        // would round them to milliseconds (in scientific notation) after a few minutes
+        m_file << std::fixed << std::setprecision(3) << "[";
+        m_first = true;
+        m_start = clock::now();
+        m_enabled.store(true, std::memory_order_relaxed);
+    }
+
+    void stop()
+    {
+        std::lock_guard lock(m_mutex);
+        this->close();
+    }
+
+    // Writes a complete event (a named span of time on the calling thread)
+    void event(const char* name, const std::string& path, clock::time_point start)
+    {
+        const auto end = clock::now();
+        const auto id  = thread_id();
+
+        std::lock_guard lock(m_mutex);
+        if (!m_file.is_open())
+        {
+            return;
+        }
+
+        // Spans that began before tracing started are clipped to the start of the trace
+        start = std::max(start, m_start);
+
+        const auto timestamp = std::chrono::duration<double, std::micro>(start - m_start).count();
+        const auto duration  = std::chrono::duration<double, std::micro>(end - start).count();
+
+        m_file << (m_first ? "\n" : ",\n") << R"({"name": ")" << name
+               << R"(", "cat": "audio", "ph": "X", "pid": 1, "tid": )" << id
+               << R"(, "ts": )" << timestamp << R"(, "dur": )" << duration;
+
+        if (!path.empty())
+        {
+            m_file << R"(, "args": {"path": ")" << escape(path) << R"("})";
+        }
+
+        m_file << "}";
+        m_first = false;
+    }
+
+private:
+    tracer()
+        : m_enabled()
+        , m_mutex()
+        , m_file()
+        , m_first()
+        , m_start()
+    {
+    }
+
+    // Small numbers are easier to read in the trace viewer than native thread IDs
+    static uint64_t thread_id()
+    {
+        static std::atomic<uint64_t> next{1};
+        thread_local const auto      id = next.fetch_add(1, std::memory_order_relaxed);
+        return id;
+    }
+
+    static std::string escape(const std::string& text)
+    {
+        std::string result;
+        for (const auto c : text)
+        {
+            switch (c)
+            {
+                case '"':
+                case '\\':
+                {
+                    result += '\\';
+                    result += c;
+                    break;
+                }
+                default:
+                {
+                    if (static_cast<unsigned char>(c) < 0x20)
+                    {
+                        char code[7]{};
+                        std::snprintf(code, sizeof(code), "\\u%04x", c);
+                        result += code;
+                    }
+                    else
+                    {
+                        result += c;
+                    }
+
+                    break;
+                }
+            }
+        }
+
+        return result;
+    }
+
+    // Must be called with the mutex held
+    void close()
+    {
+        m_enabled.store(false, std::memory_order_relaxed);
+        if (m_file.is_open())
+        {
+            m_file << "\n]\n";
+            m_file.close();
+        }
+    }
+
+    std::atomic<bool> m_enabled;
+    std::mutex        m_mutex;
+    std::ofstream     m_file;
+    bool              m_first;
+    clock::time_point m_start;
+};
+
+// Records the time until the end of the scope as a trace event. While tracing is stopped this only
+// checks a flag, and defining TNT_AUDIO_DISABLE_TRACE removes even that.
+class scoped_trace final
+{
+public:
+    explicit scoped_trace(const char* name)
+        : m_name(name)
+        , m_path()
+        , m_active(enabled())
+        , m_start(m_active ? tracer::clock::now() : tracer::clock::time_point{})
+    {
+    }
+
+    scoped_trace(const char* name, const std::filesystem::path& path)
+        : scoped_trace(name)
+    {
+        if (m_active)
+        {
+            m_path = path.string();
+        }
+    }
+
+    scoped_trace(const scoped_trace&) = delete;
+
+    scoped_trace& operator=(const scoped_trace&) = delete;
+
+    ~scoped_trace()
+    {
+        if (m_active)
+        {
+            tracer::instance().event(m_name, m_path, m_start);
+        }
+    }
+
+private:
+    static bool enabled()
+    {
+#if defined(TNT_AUDIO_DISABLE_TRACE)
+        return false;
+#else
+        return tracer::instance().enabled();
+#endif
+    }
+
+    const char*               m_name;
+    std::string               m_path;
+    bool                      m_active;
+    tracer::clock::time_point m_start;
+};
+
+}  // namespace detail
+
+/*!
+\brief Starts writing trace events of file operations from every thread to a file
+
+The events use the Chrome trace event format, so the file can be opened in chrome://tracing or
+https://ui.perfetto.dev to see which threads wait on I/O and which convert samples. Any trace
+already being written is finished first.
+
+\param[in] path Path to write the trace to
+*/
+inline void start_trace(const std::filesystem::path& path)
+{
+    detail::tracer::instance().start(path);
+}
+
+/*!
+\brief Stops tracing and finishes the trace file
+
+Does nothing if no trace is being written.
+*/
+inline void stop_trace()
+{
+    detail::tracer::instance().stop();
+}
+
+}  // namespace tnt::audio
@@ -0,0 +1,313 @@
+#pragma once
+
+#include "detail/file_handle.hpp"
+#include "detail/wave.hpp"
+#include "file_stats.hpp"
+#include "multisignal.hpp"
+#include "sample_codec.hpp"
+#include "trace.hpp"
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace tnt::audio
+{
+
+/*!
+\brief Reads the audio data of a wave file a block of frames at a time while a background thread
+reads ahead
+
+The background thread fills one buffer with the next encoded frames from the file while the caller
+decodes and processes the other, so waiting on storage overlaps with work on the previous block.
+Readers are created with wave_file::open_async_reader().
+*/
+template <typename T>
+class wave_async_reader final
+{
+public:
+    /*!
+    \brief Constructor (starts reading ahead immediately)
+    \param[in] path Path to the wave file on the system
+    \param[in] handle Open handle to the file
+    \param[in] layout Location and shape of the sample data in the file
+    \param[in] buffer_frames Number of frames read ahead at a time (zero picks a size automatically)
+    \param[in] stats Counters to record the work done in (null to not record it)
+    */
+    wave_async_reader(const std::filesystem::path&               path,
+                      std::shared_ptr<const detail::file_handle> handle,
+                      const detail::wave_layout&                 layout,
+                      size_t                                     buffer_frames = 0,
+                      std::shared_ptr<detail::stats_counters>    stats         = nullptr)
+        : m_path(path)
+        , m_layout(layout)
+        , m_position()
+        , m_current()
+        , m_offset()
+        , m_samples()
+        , m_stats(std::move(stats))
+        , m_state(std::make_unique<state>())
+    {
+        if (!handle->is_open())
+        {
+            throw std::runtime_error("Failed to open wave_file '" + m_path.string()
+                                     + "' for reading");
+        }
+
+        const auto block_align = this->block_align();
+        if (buffer_frames == 0)
+        {
+            buffer_frames = detail::block_frames(block_align);
+        }
+
+        for (auto& buffer : m_state->buffers)
+        {
+            buffer.data.resize(buffer_frames * block_align);
+        }
+
+        m_state->thread = std::thread(&wave_async_reader::prefetch,
+                                      m_state.get(),
+                                      std::move(handle),
+                                      m_layout,
+                                      buffer_frames,
+                                      m_stats);
+    }
+
+    wave_async_reader(wave_async_reader&&) = default;
+
+    wave_async_reader& operator=(wave_async_reader&&) = delete;
+
+    /*!
+    \brief Destructor (stops the background thread)
+    */
+    ~wave_async_reader()
+    {
+        if (!m_state)
+        {
+            return;
+        }
+
+        {
+            std::lock_guard lock(m_state->mutex);
+            m_state->stop = true;
+        }
+
+        m_state->condition.notify_all();
+        m_state->thread.join();
+    }
+
+    /*!
+    \brief Gets the sample rate of the encoded audio data
+    \return Sample Rate
+    */
+    size_t sample_rate() const
+    {
+        return m_layout.sample_rate;
+    }
+
+    /*!
+    \brief Gets the number of frames in the file
+    \return Size
+    */
+    size_t size() const
+    {
+        return m_layout.size;
+    }
+
+    /*!
+    \brief Gets the number of channels contained in the file
+    \return Channels
+    */
+    size_t channels() const
+    {
+        return m_layout.channels;
+    }
+
+    /*!
+    \brief Gets the index of the next frame to be read
+    \return Position
+    */
+    size_t position() const
+    {
+        return m_position;
+    }
+
+    /*!
+    \brief Reads the next frames of audio data into a block
+
+    Fills the block from its first frame with as many frames as it can hold or as are left in the
+    file, waiting only if the background thread hasn't read them yet. Any remaining frames of the
+    block are left untouched.
+
+    \param[out] block Multi-channel signal with the same number of channels as the file
+    \return Number of frames read (zero once the end of the file is reached)
+    */
+    size_t read(multisignal<T>& block)
+    {
+        if (block.channels() != m_layout.channels)
+        {
+            throw std::invalid_argument("Block channel count does not match wave_file '"
+                                        + m_path.string() + "'");
+        }
+
+        // Select the codec once so the whole read runs with the conversion resolved at compile time
+        return visit_sample_codec<T>(m_layout.subformat, [&](auto codec) {
+            return this->read_frames(codec, block);
+        });
+    }
+
+private:
+    // Encoded frames read from the file
+    struct buffer
+    {
+        std::vector<std::byte> data;
+        size_t                 frames{};
+        bool                   ready{};
+        bool                   failed{};
+    };
+
+    // Everything shared with the background thread, kept at a fixed address so the reader can move
+    struct state
+    {
+        std::array<buffer, 2>   buffers;
+        bool                    stop{};
+        std::mutex              mutex;
+        std::condition_variable condition;
+        std::thread             thread;
+    };
+
+    // Reads the sample data into the buffers in turn, waiting whenever both are full
+    static void prefetch(state*                                     shared,
+                         std::shared_ptr<const detail::file_handle> handle,
+                         detail::wave_layout                        layout,
+                         size_t                                     buffer_frames,
+                         std::shared_ptr<detail::stats_counters>    stats)
+    {
+        const auto block_align = layout.channels * detail::sample_size(layout.subformat);
+
+        size_t index = 0;
+        for (size_t frame = 0; frame < layout.size; frame += buffer_frames, index ^= 1)
+        {
+            auto& buffer = shared->buffers[index];
+            {
+                std::unique_lock lock(shared->mutex);
+                shared->condition.wait(lock, [&] { return shared->stop || !buffer.ready; });
+                if (shared->stop)
+                {
+                    return;
+                }
+            }
+
+            // The buffer belongs to this thread until it is marked ready
+            const auto count    = std::min(buffer_frames, layout.size - frame);
+            const auto position = layout.data_position + frame * block_align;
+
+            bool success{};
+            {
+                const detail::scoped_trace trace("read");
+                const detail::scoped_time  time(stats.get(), &detail::stats_counters::io_time);
+                success = handle->read_at(position, buffer.data.data(), count * block_align);
+            }
+
+            if (success)
+            {
+                detail::count_read(stats.get(), count * block_align);
+            }
+
+            {
+                std::lock_guard lock(shared->mutex);
+                buffer.frames = count;
+                buffer.failed = !success;
+                buffer.ready  = true;
+            }
+
+            shared->condition.notify_all();
+            if (!success)
+            {
+                return;
+            }
+        }
+    }
+
+    template <typename Codec>
+    size_t read_frames(Codec, multisignal<T>& block)
+    {
+        const auto frames      = std::min(block.size(), m_layout.size - m_position);
+        const auto block_align = m_layout.channels * Codec::sample_size;
+
+        for (size_t frame = 0; frame < frames;)
+        {
+            auto& buffer = m_state->buffers[m_current];
+            {
+                // Time spent here is time the background thread fell behind
+                const detail::scoped_trace trace("wait");
+                std::unique_lock           lock(m_state->mutex);
+                m_state->condition.wait(lock, [&] { return buffer.ready; });
+                if (buffer.failed)
+                {
+                    throw std::runtime_error("Unexpected EOF for wave_file '" + m_path.string()
+                                             + "'");
+                }
+            }
+
+            const auto count = std::min(frames - frame, buffer.frames - m_offset);
+            if (m_samples.size() < count * m_layout.channels)
+            {
+                m_samples.resize(count * m_layout.channels);
+            }
+
+            {
+                const detail::scoped_trace trace("decode");
+                const detail::scoped_time  time(m_stats.get(),
+                                                &detail::stats_counters::decode_time);
+                Codec::decode(buffer.data.data() + m_offset * block_align,
+                              m_samples.data(),
+                              count * m_layout.channels);
+                detail::deinterleave(m_samples.data(), count, frame, block);
+            }
+
+            frame += count;
+            m_offset += count;
+
+            // Hand a finished buffer back to the background thread to fill with the next frames
+            if (m_offset == buffer.frames)
+            {
+                {
+                    std::lock_guard lock(m_state->mutex);
+                    buffer.ready = false;
+                }
+
+                m_state->condition.notify_all();
+                m_current ^= 1;
+                m_offset = 0;
+            }
+        }
+
+        m_position += frames;
+        return frames;
+    }
+
+    size_t block_align() const
+    {
+        return m_layout.channels * detail::sample_size(m_layout.subformat);
+    }
+
+    std::filesystem::path                   m_path;
+    detail::wave_layout                     m_layout;
+    size_t                                  m_position;
+    size_t                                  m_current;
+    size_t                                  m_offset;
+    std::vector<T>                          m_samples;
+    std::shared_ptr<detail::stats_counters> m_stats;
+    std::unique_ptr<state>                  m_state;
+};
+
+}  // namespace tnt::audio
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <utility>
+
+namespace tnt::audio
+{
+
+/*!
+\brief Read only view of a single channel of interleaved sample data stored in memory
+
+The view does not copy the sample data. It shares ownership of the storage it refers to, so it stays
+valid after the object that created it is destroyed.
+*/
+template <typename T>
+class wave_channel_view final
+{
+public:
+    /*!
+    \brief Constructor
+    \param[in] storage Owner of the memory containing the samples
+    \param[in] data Pointer to the first sample of the channel
+    \param[in] size Number of samples in the channel
+    \param[in] stride Distance in bytes between consecutive samples of the channel
+    */
+    wave_channel_view(std::shared_ptr<const void> storage,
+                      const std::byte*            data,
+                      size_t                      size,
+                      size_t                      stride)
+        : m_storage(std::move(storage))
+        , m_data(data)
+        , m_size(size)
+        , m_stride(stride)
+    {}
+
+    /*!
+    \brief Gets the number of samples in the channel
+    \return Size
+    */
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    /*!
+    \brief Gets the distance in bytes between consecutive samples of the channel
+    \return Stride
+    */
+    size_t stride() const
+    {
+        return m_stride;
+    }
+
+    /*!
+    \brief Gets a sample from the channel
+    \param[in] n Index of the sample
+    \return Sample
+    */
+    T operator[](size_t n) const
+    {
+        // Wave data is only guaranteed to be 2 byte aligned, so copy rather than dereference
+        T value{};
+        std::memcpy(&value, m_data + n * m_stride, sizeof(value));
+        return value;
+    }
+
+private:
+    std::shared_ptr<const void> m_storage;
+    const std::byte*            m_data;
+    size_t                      m_size;
+    size_t                      m_stride;
+};
+
+}  // namespace tnt::audio
@@ -1,16 +1,38 @@
 #pragma once
 
+#include "detail/file_handle.hpp"
+#include "detail/mapped_file.hpp"
+#include "detail/parallel.hpp"
+#include "detail/wave.hpp"
+#include "detail/wave_header.hpp"
 #include "file_base.hpp"
-
+#include "file_stats.hpp"
+#include "trace.hpp"
+#include "wave_async_reader.hpp"
+#include "wave_channel_view.hpp"
+#include "wave_format.hpp"
+#include "wave_lazy_signal.hpp"
+#include "wave_reader.hpp"
+#include "wave_writer.hpp"
+
+#include <algorithm>
 #include <array>
+#include <cassert>
+#include <chrono>
+#include <climits>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <filesystem>
-#include <fstream>
 #include <limits>
+#include <memory>
+#include <optional>
 #include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <vector>
 
 // Assert that data types are the correct size
 static_assert(sizeof(uint8_t) * CHAR_BIT == 8);
@@ -22,28 +44,6 @@ static_assert(sizeof(double) * CHAR_BIT == 64);
 namespace tnt::audio
 {
 
-/*!
-\brief Represents valid wave file formats
-*/
-enum class wave_format
-{
-    pcm        = 0x0001,
-    ieee_float = 0x0003,
-};
-
-/*!
-\brief Represents valid wave file subformats
-*/
-enum class wave_subformat
-{
-    pcm_uint8,
-    pcm_int16,
-    pcm_int24,
-    pcm_int32,
-    ieee_float32,
-    ieee_float64,
-};
-
 /*!
 \brief Wave file object used to read and write wave files
 */
@@ -54,30 +54,74 @@ public:
     /*!
     \brief Constructor
     \param[in] path Path to the wave file on the system
+    \param[in] mode How sample data is read from the file
+    \param[in] threads Number of threads for parallel read mode (zero uses one per hardware thread)
     */
-    explicit wave_file(const std::filesystem::path& path)
+    explicit wave_file(const std::filesystem::path& path,
+                       const wave_read_mode&        mode    = wave_read_mode::stream,
+                       size_t                       threads = 0)
         : m_path(path)
-        , m_sample_rate()
-        , m_size()
-        , m_channels()
-        , m_format()
-        , m_data_type()
-        , m_data_position()
+        , m_layout()
         , m_initialized()
+        , m_read_mode(mode)
+        , m_threads(threads)
+        , m_in_memory()
+        , m_handle()
+        , m_mapping()
+        , m_reader()
+        , m_stats()
+        , m_open_stats()
+        , m_last_stats()
     {
-        if (std::filesystem::exists(path))
+        const detail::scoped_trace trace("open", path);
+
+        // A file that doesn't exist yet (or is empty) has no header to parse, but can still be
+        // written. Any other file must parse successfully.
+        auto handle = std::make_shared<const detail::file_handle>(path);
+        if (handle->is_open())
         {
-            try
+            m_handle = std::move(handle);
+
+            std::error_code error{};
+            if (std::filesystem::file_size(path, error) != 0)
             {
                 this->initialize();
             }
-            catch (...)
-            {
-                // Do nothing
-            }
         }
     }
 
+    /*!
+    \brief Constructor (decodes a wave file that is already in memory)
+
+    The memory is read in place rather than copied, so it must outlive this object and any readers
+    or views created from it. Files in memory can't be written.
+
+    \param[in] data Pointer to the first byte of the wave file
+    \param[in] size Size of the wave file in bytes
+    \param[in] mode How sample data is read (stream and mapped both decode directly from memory)
+    \param[in] threads Number of threads for parallel read mode (zero uses one per hardware thread)
+    */
+    wave_file(const std::byte*      data,
+              size_t                size,
+              const wave_read_mode& mode    = wave_read_mode::mapped,
+              size_t                threads = 0)
+        : m_path("<memory>")
+        , m_layout()
+        , m_initialized()
+        , m_read_mode(mode)
+        , m_threads(threads)
+        , m_in_memory(true)
+        , m_handle()
+        , m_mapping(std::make_shared<const detail::mapped_file>(data, size))
+        , m_reader()
+        , m_stats()
+        , m_open_stats()
+        , m_last_stats()
+    {
+        const detail::scoped_trace trace("open");
+        this->initialize();
+    }
+
     /*!
     \brief Destructor
     */
@@ -86,7 +130,7 @@ public:
     /*!
     \copydoc file_base::duration()
     */
-    virtual double duration() override
+    virtual double duration() const override
     {
         assert(m_initialized);
 
@@ -96,31 +140,79 @@ public:
     /*!
     \copydoc file_base::sample_rate()
     */
-    virtual size_t sample_rate() override
+    virtual size_t sample_rate() const override
     {
         assert(m_initialized);
 
-        return m_sample_rate;
+        return m_layout.sample_rate;
     }
 
     /*!
     \copydoc file_base::size()
     */
-    virtual size_t size() override
+    virtual size_t size() const override
     {
         assert(m_initialized);
 
-        return m_size;
+        return m_layout.size;
     }
 
     /*!
     \copydoc file_base::channels()
     */
-    virtual size_t channels() override
+    virtual size_t channels() const override
     {
         assert(m_initialized);
 
-        return m_channels;
+        return m_layout.channels;
+    }
+
+    /*!
+    \brief Gets the speaker positions of the channels from a WAVE_FORMAT_EXTENSIBLE header
+    \return Channel mask (bit i set means speaker i is present) or zero if not specified
+    */
+    uint32_t channel_mask() const
+    {
+        assert(m_initialized);
+
+        return m_layout.channel_mask;
+    }
+
+    /*!
+    \brief Finds the channels of the file that feed the given speakers
+
+    Channels are assigned to the set bits of the channel mask in increasing order, as
+    WAVE_FORMAT_EXTENSIBLE specifies. A file without a channel mask assigns channel i to bit i. The
+    result can be passed to read(size_t start_frame, size_t frame_count, const std::vector<size_t>&
+    channels) so only those channels are decoded.
+
+    \param[in] speaker_mask Speakers to select (bit i selects speaker i)
+    \return Indices of the channels feeding the selected speakers in increasing order
+    */
+    std::vector<size_t> select_channels(uint32_t speaker_mask) const
+    {
+        const auto channels = this->channels();
+        const auto mask     = m_layout.channel_mask;
+
+        std::vector<size_t> selection;
+        size_t              channel = 0;
+        for (size_t bit = 0; bit < 32 && channel < channels; ++bit)
+        {
+            const auto speaker = uint32_t{1} << bit;
+            if (mask != 0 && (mask & speaker) == 0)
+            {
+                continue;
+            }
+
+            if (speaker_mask & speaker)
+            {
+                selection.push_back(channel);
+            }
+
+            ++channel;
+        }
+
+        return selection;
     }
 
     /*!
@@ -128,106 +220,216 @@ public:
     */
     virtual multisignal<T> read() override
     {
-        std::ifstream file(m_path, std::ios::binary);
-        if (!file.is_open())
+        return this->read_range(0, std::numeric_limits<size_t>::max(), nullptr);
+    }
+
+    /*!
+    \copydoc file_base::read(size_t start_frame, size_t frame_count)
+    */
+    virtual multisignal<T> read(size_t start_frame, size_t frame_count) override
+    {
+        return this->read_range(start_frame, frame_count, nullptr);
+    }
+
+    /*!
+    \copydoc file_base::read(size_t start_frame, size_t frame_count, const std::vector<size_t>&
+    channels)
+    */
+    virtual multisignal<T> read(size_t                     start_frame,
+                                size_t                     frame_count,
+                                const std::vector<size_t>& channels) override
+    {
+        return this->read_range(start_frame, frame_count, &channels);
+    }
+
+    /*!
+    \copydoc file_base::read_into(multisignal<T>& signal)
+    */
+    virtual size_t read_into(multisignal<T>& signal) override
+    {
+        return this->read_range_into(signal, 0, std::numeric_limits<size_t>::max(), nullptr);
+    }
+
+    /*!
+    \copydoc file_base::read_into(multisignal<T>& signal, size_t start_frame, size_t frame_count)
+    */
+    virtual size_t read_into(multisignal<T>& signal,
+                             size_t          start_frame,
+                             size_t          frame_count) override
+    {
+        return this->read_range_into(signal, start_frame, frame_count, nullptr);
+    }
+
+    /*!
+    \copydoc file_base::read_at(size_t start_frame, size_t frame_count) const
+    */
+    virtual multisignal<T> read_at(size_t start_frame, size_t frame_count) const override
+    {
+        multisignal<T> signal(this->sample_rate(), 0, this->channels());
+        this->read_at(signal, start_frame, frame_count);
+
+        return signal;
+    }
+
+    /*!
+    \copydoc file_base::read_at(multisignal<T>& signal, size_t start_frame, size_t frame_count)
+    const
+
+    Reads are positional reads through the handle opened on construction, so they share no file
+    position or buffers with each other or with the other reads of this object. Every call reads on
+    the calling thread, whatever the read mode, and doesn't update last_stats().
+    */
+    virtual size_t read_at(multisignal<T>& signal,
+                           size_t          start_frame,
+                           size_t          frame_count) const override
+    {
+        auto reader = this->shared_reader();
+
+        frame_count = this->range_size(start_frame, frame_count);
+        if (signal.sample_rate() != this->sample_rate() || signal.size() != frame_count
+            || signal.channels() != this->channels())
+        {
+            signal = multisignal<T>(this->sample_rate(), frame_count, this->channels());
+        }
+
+        reader.seek(start_frame);
+        reader.read(signal);
+
+        return frame_count;
+    }
+
+    /*!
+    \copydoc file_base::enable_stats()
+    */
+    virtual void enable_stats(bool enabled) override
+    {
+        m_stats.reset();
+        m_last_stats = {};
+        if (enabled)
+        {
+            m_stats = std::make_shared<detail::stats_counters>();
+            m_stats->add(m_open_stats);
+        }
+
+        // The cached reader holds on to the previous counters
+        m_reader.reset();
+    }
+
+    /*!
+    \copydoc file_base::stats()
+    */
+    virtual file_stats stats() override
+    {
+        return m_stats ? m_stats->snapshot() : file_stats{};
+    }
+
+    /*!
+    \copydoc file_base::last_stats()
+    */
+    virtual file_stats last_stats() override
+    {
+        return m_last_stats;
+    }
+
+    /*!
+    \brief Opens a reader that reads the audio data a block of frames at a time
+
+    The reader uses the same read mode as this file (readers always read sequentially in parallel
+    read mode).
+
+    \return Reader positioned at the first frame
+    */
+    wave_reader<T> open_reader()
+    {
+        if (m_read_mode == wave_read_mode::mapped || m_in_memory)
+        {
+            return wave_reader<T>(m_path, this->mapping(), this->layout(), m_stats);
+        }
+
+        return wave_reader<T>(m_path, this->handle(), this->layout(), m_stats);
+    }
+
+    /*!
+    \brief Opens a reader that reads the audio data a block of frames at a time while a background
+    thread reads ahead
+    \param[in] buffer_frames Number of frames read ahead at a time (zero picks a size automatically)
+    \return Reader positioned at the first frame
+    */
+    wave_async_reader<T> open_async_reader(size_t buffer_frames = 0)
+    {
+        if (m_in_memory)
         {
-            throw std::runtime_error("Failed to open wave_file '" + m_path.string()
-                                     + "' for reading");
+            throw std::runtime_error("wave_file '" + m_path.string()
+                                     + "' is in memory and can't be read asynchronously");
         }
 
+        return wave_async_reader<T>(m_path,
+                                    this->handle(),
+                                    this->layout(),
+                                    buffer_frames,
+                                    m_stats);
+    }
+
+    /*!
+    \brief Gets a signal whose sample data is only decoded when it is accessed
+
+    Nothing is decoded until a frame is accessed, after which the page of frames containing it is
+    decoded and cached. The signal reads through its own reader, so it can be used alongside this
+    file and stays valid after it is destroyed, but writing to the file invalidates it.
+
+    \param[in] page_frames Number of frames decoded at a time (zero picks a size automatically)
+    \param[in] cache_pages Maximum number of decoded pages kept
+    \return Lazily decoded signal
+    */
+    wave_lazy_signal<T> read_lazy(size_t page_frames = 0, size_t cache_pages = 64)
+    {
         assert(m_initialized);
 
-        // Seek to the start of the data
-        file.seekg(m_data_position);
+        if (page_frames == 0)
+        {
+            page_frames = detail::block_frames(m_layout.channels
+                                               * detail::sample_size(m_layout.subformat));
+        }
 
-        multisignal<T> signal(this->sample_rate(), this->size(), this->channels());
-        std::for_each(signal.begin(), signal.end(), [this, &file](auto& samples) {
-            std::for_each(samples.begin(), samples.end(), [this, &file](auto& sample) {
-                // TODO: support other formats
-                switch (m_data_type)
-                {
-                    case wave_subformat::pcm_uint8:
-                    {
-                        uint8_t value{};
-                        file.read(reinterpret_cast<char*>(&value), sizeof(value));
-
-                        constexpr auto scale =
-                            (static_cast<size_t>(std::numeric_limits<uint8_t>::max()) + 1) / 2;
-
-                        sample = (static_cast<T>(value) - scale) / scale;
-                        break;
-                    }
-                    case wave_subformat::pcm_int16:
-                    {
-                        int16_t value{};
-                        file.read(reinterpret_cast<char*>(&value), sizeof(value));
-
-                        constexpr auto scale = static_cast<size_t>(
-                                                   std::numeric_limits<int16_t>::max())
-                                             + 1;
-
-                        sample = static_cast<T>(value) / scale;
-                        break;
-                    }
-                    case wave_subformat::pcm_int24:
-                    {
-                        // No built-in type for 24 bit data
-                        constexpr auto int24_max  = 0x7FFFFF;
-                        constexpr auto uint24_max = 0x1000000;
-
-                        // Store in an int32 because there is no built in 24 bit type
-                        int32_t value{};
-
-                        // Only read 3 bytes because it is a 24 bit value
-                        file.read(reinterpret_cast<char*>(&value), 3);
-
-                        // Get 32 bit integer from 24 bit two's complement value
-                        if (value > int24_max)
-                        {
-                            value -= uint24_max;
-                        }
-
-                        constexpr auto scale = int24_max + 1;
-
-                        sample = static_cast<T>(value) / scale;
-                        break;
-                    }
-                    case wave_subformat::pcm_int32:
-                    {
-                        int32_t value{};
-                        file.read(reinterpret_cast<char*>(&value), sizeof(value));
-
-                        constexpr auto scale = static_cast<size_t>(
-                                                   std::numeric_limits<int32_t>::max())
-                                             + 1;
-
-                        sample = static_cast<T>(value) / scale;
-                        break;
-                    }
-                    case wave_subformat::ieee_float32:
-                    {
-                        float value{};
-                        file.read(reinterpret_cast<char*>(&value), sizeof(value));
-                        sample = static_cast<T>(value);
-                        break;
-                    }
-                    case wave_subformat::ieee_float64:
-                    {
-                        double value{};
-                        file.read(reinterpret_cast<char*>(&value), sizeof(value));
-                        sample = static_cast<T>(value);
-                        break;
-                    }
-                    default:
-                    {
-                        // The code should never get here
-                        throw std::runtime_error("Your hair is on fire!");
-                    }
-                }
-            });
-        });
+        return wave_lazy_signal<T>(this->open_reader(), page_frames, cache_pages);
+    }
 
-        return signal;
+    /*!
+    \brief Gets a view of a single channel directly over the mapped sample data
+
+    This is only possible when the samples are stored as T (ieee_float32 for float and ieee_float64
+    for double). The file is mapped on first use regardless of the read mode. Writing to the file
+    invalidates any existing views.
+
+    \param[in] channel Index of the channel
+    \return View of the channel
+    */
+    wave_channel_view<T> view(size_t channel)
+    {
+        const auto is_float  = m_layout.subformat == wave_subformat::ieee_float32;
+        const auto is_double = m_layout.subformat == wave_subformat::ieee_float64;
+        if (!(std::is_same_v<T, float> && is_float) && !(std::is_same_v<T, double> && is_double))
+        {
+            throw std::runtime_error("Sample data in wave_file '" + m_path.string()
+                                     + "' can't be viewed without conversion");
+        }
+
+        if (channel >= this->channels())
+        {
+            throw std::out_of_range("Invalid channel for wave_file '" + m_path.string() + "'");
+        }
+
+        const auto& mapping  = this->mapping();
+        const auto  position = m_layout.data_position;
+        if (mapping->size() < position + this->size() * this->channels() * sizeof(T))
+        {
+            throw std::runtime_error("Unexpected EOF for wave_file '" + m_path.string() + "'");
+        }
+
+        return wave_channel_view<T>(mapping,
+                                    mapping->data() + position + channel * sizeof(T),
+                                    this->size(),
+                                    this->channels() * sizeof(T));
     }
 
     /*!
@@ -277,457 +479,368 @@ public:
                        const wave_format&    format,
                        const wave_subformat& subformat)
     {
-        header riff_header{};
-        std::string("RIFF").copy(riff_header.id, sizeof(riff_header.id));
+        const detail::scoped_stats call(m_stats.get(), m_last_stats);
 
-        char wave[4]{};
-        std::string("WAVE").copy(wave, sizeof(wave));
+        auto writer = this->open_writer(signal.sample_rate(), signal.channels(), format, subformat);
+        writer.write(signal);
+        writer.finalize();
 
-        header format_header{};
-        std::string("fmt ").copy(format_header.id, sizeof(format_header.id));
+        // The header was just written, so the metadata is known without parsing it again
+        m_layout      = writer.layout();
+        m_initialized = true;
 
-        format_chunk format_chunk{};
-        format_chunk.format      = static_cast<uint16_t>(format);
-        format_chunk.channels    = static_cast<uint16_t>(signal.channels());
-        format_chunk.sample_rate = static_cast<uint32_t>(signal.sample_rate());
+        // Open the handle now so const reads of a file that didn't exist on construction work
+        this->handle();
+    }
 
-        std::vector<std::byte> format_ext_buffer;
+    /*!
+    \brief Gets the size of a wave file encoded in memory, so a buffer can be allocated up front
+    \param[in] signal Multi-channel signal containing audio data to encode
+    \param[in] format Format to encode the wave file in
+    \param[in] subformat Subformat indicating the data type to store the data in
+    \return Size of the header plus the encoded sample data in bytes
+    */
+    static size_t encoded_size(const multisignal<T>& signal,
+                               const wave_format&    format    = wave_format::ieee_float,
+                               const wave_subformat& subformat = wave_subformat::ieee_float64)
+    {
+        const auto header = memory_header(signal, format, subformat);
+        return header.bytes.size() + signal.size() * header.block_align;
+    }
 
-        switch (format)
+    /*!
+    \brief Encodes a wave file into memory instead of writing it to the file system
+    \param[in] signal Multi-channel signal containing audio data to encode
+    \param[in] format Format to encode the wave file in
+    \param[in] subformat Subformat indicating the data type to store the data in
+    \return Contents of the wave file
+    */
+    static std::vector<std::byte> encode(
+        const multisignal<T>& signal,
+        const wave_format&    format    = wave_format::ieee_float,
+        const wave_subformat& subformat = wave_subformat::ieee_float64)
+    {
+        std::vector<std::byte> bytes(encoded_size(signal, format, subformat));
+        encode(signal, format, subformat, bytes.data(), bytes.size());
+        return bytes;
+    }
+
+    /*!
+    \brief Encodes a wave file into a buffer provided by the caller
+    \param[in] signal Multi-channel signal containing audio data to encode
+    \param[in] format Format to encode the wave file in
+    \param[in] subformat Subformat indicating the data type to store the data in
+    \param[out] data Buffer to encode the wave file into
+    \param[in] size Size of the buffer in bytes (at least encoded_size())
+    \return Number of bytes written to the buffer
+    */
+    static size_t encode(const multisignal<T>& signal,
+                         const wave_format&    format,
+                         const wave_subformat& subformat,
+                         std::byte*            data,
+                         size_t                size)
+    {
+        const auto header = memory_header(signal, format, subformat);
+        const auto total  = header.bytes.size() + signal.size() * header.block_align;
+        if (size < total)
         {
-            case wave_format::pcm:
-            {
-                format_ext_pcm format_ext{};
-                format_ext_buffer.resize(sizeof(format_ext));
+            throw std::invalid_argument("Buffer is too small for wave_file '<memory>'");
+        }
 
-                switch (subformat)
-                {
-                    case wave_subformat::pcm_uint8:
-                    {
-                        format_ext.bits_per_sample = 8;
-                        break;
-                    }
-                    case wave_subformat::pcm_int16:
-                    {
-                        format_ext.bits_per_sample = 16;
-                        break;
-                    }
-                    case wave_subformat::pcm_int24:
-                    {
-                        format_ext.bits_per_sample = 24;
-                        break;
-                    }
-                    case wave_subformat::pcm_int32:
-                    {
-                        format_ext.bits_per_sample = 32;
-                        break;
-                    }
-                    default:
-                    {
-                        throw std::runtime_error("Invalid subformat for wave_file '"
-                                                 + m_path.string() + "'");
-                        break;
-                    }
-                }
+        std::memcpy(data, header.bytes.data(), header.bytes.size());
+        data += header.bytes.size();
 
-                format_chunk.byte_rate = format_chunk.sample_rate * format_ext.bits_per_sample
-                                       * format_chunk.channels / CHAR_BIT;
-                format_chunk.block_align = format_ext.bits_per_sample * format_chunk.channels
-                                         / CHAR_BIT;
-                std::memcpy(format_ext_buffer.data(), &format_ext, format_ext_buffer.size());
-                break;
-            }
-            case wave_format::ieee_float:
-            {
-                format_ext_ieee_float format_ext{};
-                format_ext_buffer.resize(sizeof(format_ext));
+        // Encode straight into the buffer, staging only one block of interleaved samples at a time
+        visit_sample_codec<T>(subformat, [&](auto codec) {
+            using codec_type = decltype(codec);
 
-                switch (subformat)
-                {
-                    case wave_subformat::ieee_float32:
-                    {
-                        format_ext.bits_per_sample = 32;
-                        break;
-                    }
-                    case wave_subformat::ieee_float64:
-                    {
-                        format_ext.bits_per_sample = 64;
-                        break;
-                    }
-                    default:
-                    {
-                        throw std::runtime_error("Invalid subformat for wave_file '"
-                                                 + m_path.string() + "'");
-                        break;
-                    }
-                }
+            const auto channels     = signal.channels();
+            const auto block_frames = detail::block_frames(header.block_align);
 
-                format_chunk.byte_rate = format_chunk.sample_rate * format_ext.bits_per_sample
-                                       * format_chunk.channels / CHAR_BIT;
-                format_chunk.block_align = format_ext.bits_per_sample * format_chunk.channels
-                                         / CHAR_BIT;
-                std::memcpy(format_ext_buffer.data(), &format_ext, format_ext_buffer.size());
-                break;
-            }
-            default:
+            std::vector<T> samples(std::min(block_frames, signal.size()) * channels);
+            for (size_t offset = 0; offset < signal.size(); offset += block_frames)
             {
-                std::stringstream format_stream;
-                format_stream << std::hex << static_cast<size_t>(format);
-                throw std::runtime_error("Invalid format '" + format_stream.str()
-                                         + "' for wave_file '" + m_path.string() + "'");
+                const auto count = std::min(block_frames, signal.size() - offset);
+
+                detail::interleave(signal, offset, count, samples.data());
+                codec_type::encode(samples.data(),
+                                   data + offset * header.block_align,
+                                   count * channels);
             }
-        }
+        });
 
-        format_header.size = static_cast<uint32_t>(sizeof(format_chunk) + format_ext_buffer.size());
+        return total;
+    }
 
-        header data_header{};
-        std::string("data").copy(data_header.id, sizeof(data_header.id));
-        data_header.size = static_cast<uint32_t>(signal.size() * format_chunk.block_align);
+    /*!
+    \brief Opens a writer that writes audio data to the file a block of frames at a time
 
-        riff_header.size = static_cast<uint32_t>(sizeof(wave) + sizeof(format_header)
-                                                 + format_header.size + sizeof(data_header)
-                                                 + data_header.size);
+    Any existing contents of the file are replaced. The metadata of this object is not updated by
+    the writer, construct a new wave_file once the writer is finalized to read the result.
 
-        std::ofstream file(m_path, std::ios::binary | std::ios::trunc);
-        if (!file.is_open())
+    \param[in] sample_rate Sample rate of the audio data
+    \param[in] channels Number of channels of audio data
+    \param[in] format Format to write the wave file in
+    \param[in] subformat Subformat indicating the data type to store the data in
+    \return Writer positioned after the header
+    */
+    wave_writer<T> open_writer(size_t                sample_rate,
+                               size_t                channels,
+                               const wave_format&    format    = wave_format::ieee_float,
+                               const wave_subformat& subformat = wave_subformat::ieee_float64)
+    {
+        if (m_in_memory)
         {
-            throw std::runtime_error("Failed to open wave_file '" + m_path.string()
-                                     + "' for writing");
+            throw std::runtime_error("wave_file '" + m_path.string()
+                                     + "' is in memory and can't be written");
         }
 
-        file.write(reinterpret_cast<const char*>(&riff_header), sizeof(riff_header));
-        file.write(wave, sizeof(wave));
-        file.write(reinterpret_cast<const char*>(&format_header), sizeof(format_header));
-        file.write(reinterpret_cast<const char*>(&format_chunk), sizeof(format_chunk));
-        file.write(reinterpret_cast<const char*>(format_ext_buffer.data()),
-                   format_ext_buffer.size());
-        file.write(reinterpret_cast<const char*>(&data_header), sizeof(data_header));
-
-        std::for_each(signal.begin(), signal.end(), [this, &subformat, &file](auto& samples) {
-            std::for_each(samples.begin(), samples.end(), [this, &subformat, &file](auto& sample) {
-                // TODO: support other formats
-                switch (subformat)
-                {
-                    case wave_subformat::pcm_uint8:
-                    {
-                        constexpr auto scale =
-                            (static_cast<size_t>(std::numeric_limits<uint8_t>::max()) + 1) / 2;
-
-                        const uint8_t value = static_cast<uint8_t>(
-                            std::clamp<double>(sample * scale + scale,
-                                               std::numeric_limits<uint8_t>::min(),
-                                               std::numeric_limits<uint8_t>::max()));
-
-                        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
-                        break;
-                    }
-                    case wave_subformat::pcm_int16:
-                    {
-                        constexpr auto scale = static_cast<size_t>(
-                                                   std::numeric_limits<int16_t>::max())
-                                             + 1;
-
-                        const int16_t value = static_cast<int16_t>(
-                            std::clamp<double>(sample * scale,
-                                               std::numeric_limits<int16_t>::min(),
-                                               std::numeric_limits<int16_t>::max()));
-
-                        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
-                        break;
-                    }
-                    case wave_subformat::pcm_int24:
-                    {
-                        // No built-in type for 24 bit data
-                        constexpr auto int24_min  = -0x800000;
-                        constexpr auto int24_max  = 0x7FFFFF;
-                        constexpr auto uint24_max = 0x1000000;
-                        constexpr auto scale      = int24_max + 1;
-
-                        // Store in an int32 because there is no built in 24 bit type
-                        int32_t value = static_cast<int32_t>(
-                            std::clamp<double>(sample * scale, int24_min, int24_max));
-
-                        // Get 24 bit two's complement value from a 32 bit integer
-                        if (value < 0)
-                        {
-                            value += uint24_max;
-                        }
-
-                        // Only write 3 bytes because it is a 24 bit value
-                        file.write(reinterpret_cast<char*>(&value), 3);
-                        break;
-                    }
-                    case wave_subformat::pcm_int32:
-                    {
-                        constexpr auto scale = static_cast<size_t>(
-                                                   std::numeric_limits<int32_t>::max())
-                                             + 1;
-
-                        const int32_t value = static_cast<int32_t>(
-                            std::clamp<double>(sample * scale,
-                                               std::numeric_limits<int32_t>::min(),
-                                               std::numeric_limits<int32_t>::max()));
-
-                        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
-                        break;
-                    }
-                    case wave_subformat::ieee_float32:
-                    {
-                        float value = static_cast<float>(sample);
-                        file.write(reinterpret_cast<char*>(&value), sizeof(value));
-                        break;
-                    }
-                    case wave_subformat::ieee_float64:
-                    {
-                        double value = static_cast<double>(sample);
-                        file.write(reinterpret_cast<char*>(&value), sizeof(value));
-                        break;
-                    }
-                    default:
-                    {
-                        // The code should never get here
-                        throw std::runtime_error("Your hair is on fire!");
-                    }
-                }
-            });
-        });
-
-        // Close the file for writing so we can read it to initialize member data
-        file.close();
+        // The file is about to be replaced, so drop the old mapping and the reader using it
+        m_reader.reset();
+        m_mapping.reset();
 
-        // Initialize to fill in member data
-        this->initialize();
+        return wave_writer<T>(m_path, sample_rate, channels, format, subformat, m_stats);
     }
 
 private:
-    void initialize()
+    // Reads a range of frames, either every channel or only the selected ones
+    multisignal<T> read_range(size_t                     start_frame,
+                              size_t                     frame_count,
+                              const std::vector<size_t>* selection)
+    {
+        // Opening the reader first reports a file that can't be read before anything else
+        this->reader();
+
+        assert(m_initialized);
+
+        frame_count = this->range_size(start_frame, frame_count);
+
+        const auto     channels = selection ? selection->size() : this->channels();
+        multisignal<T> signal(this->sample_rate(), frame_count, channels);
+        this->read_range_into(signal, start_frame, frame_count, selection);
+
+        return signal;
+    }
+
+    // Reads a range of frames into a signal, reusing its storage if it already has the right shape
+    size_t read_range_into(multisignal<T>&            signal,
+                           size_t                     start_frame,
+                           size_t                     frame_count,
+                           const std::vector<size_t>* selection)
     {
-        std::ifstream file(m_path, std::ios::binary);
-        if (!file.is_open())
+        const detail::scoped_stats call(m_stats.get(), m_last_stats);
+
+        auto& reader = this->reader();
+
+        assert(m_initialized);
+
+        frame_count = this->range_size(start_frame, frame_count);
+
+        const auto channels = selection ? selection->size() : this->channels();
+        if (signal.sample_rate() != this->sample_rate() || signal.size() != frame_count
+            || signal.channels() != channels)
         {
-            throw std::runtime_error("Failed to open wave_file '" + m_path.string() + "'");
+            signal = multisignal<T>(this->sample_rate(), frame_count, channels);
+        }
+
+        if (m_read_mode != wave_read_mode::parallel)
+        {
+            reader.seek(start_frame);
+            if (selection)
+            {
+                reader.read(signal, *selection);
+            }
+            else
+            {
+                reader.read(signal);
+            }
+
+            return frame_count;
         }
 
-        header riff_header{};
-        file.read(reinterpret_cast<char*>(&riff_header), sizeof(riff_header));
-        if (std::strncmp(riff_header.id, "RIFF", sizeof(riff_header.id)))
+        // Every frame has the same size, so disjoint ranges of frames can be read and decoded
+        // independently into disjoint ranges of the signal. Ranges are kept at least one buffer
+        // long so small reads don't pay for threads they can't use.
+        const auto threads = detail::thread_count(m_threads);
+        const auto minimum = detail::block_frames(m_layout.channels
+                                                  * detail::sample_size(m_layout.subformat));
+        const auto range   = std::max(minimum, (frame_count + threads - 1) / threads);
+        const auto ranges  = (frame_count + range - 1) / range;
+
+        // Positional reads let every thread share the handle to the file (or the memory holding
+        // it)
+        const auto handle = m_in_memory ? nullptr : this->handle();
+        const auto layout = this->layout();
+
+        detail::parallel_for(ranges, threads, [&](size_t i) {
+            const auto offset = i * range;
+            const auto frames = std::min(range, frame_count - offset);
+
+            auto range_reader = m_in_memory ? wave_reader<T>(m_path, m_mapping, layout, m_stats)
+                                            : wave_reader<T>(m_path, handle, layout, m_stats);
+            range_reader.seek(start_frame + offset);
+            if (selection)
+            {
+                range_reader.read(signal, offset, frames, *selection);
+            }
+            else
+            {
+                range_reader.read(signal, offset, frames);
+            }
+        });
+
+        return frame_count;
+    }
+
+    // Builds the header of a wave file encoded in memory
+    static detail::wave_header memory_header(const multisignal<T>& signal,
+                                             const wave_format&    format,
+                                             const wave_subformat& subformat)
+    {
+        // Sizes too large for a RIFF header make it an RF64 header
+        const auto data_size = signal.size() * signal.channels() * detail::sample_size(subformat);
+        return detail::make_header("<memory>",
+                                   format,
+                                   subformat,
+                                   signal.sample_rate(),
+                                   signal.channels(),
+                                   data_size);
+    }
+
+    // Gets the number of frames of a range that lie within the file
+    size_t range_size(size_t start_frame, size_t frame_count) const
+    {
+        if (start_frame > m_layout.size)
         {
-            throw std::runtime_error("Invalid RIFF header for wave_file '" + m_path.string() + "'");
+            throw std::out_of_range("Invalid frame range for wave_file '" + m_path.string() + "'");
         }
 
-        char wave[4]{};
-        file.read(reinterpret_cast<char*>(&wave), sizeof(wave));
-        if (std::strncmp(wave, "WAVE", sizeof(wave)))
+        return std::min(frame_count, m_layout.size - start_frame);
+    }
+
+    // Gets the handle to the file, opening it first if necessary (such as when the file didn't
+    // exist on construction)
+    const std::shared_ptr<const detail::file_handle>& handle()
+    {
+        if (!m_handle || !m_handle->is_open())
         {
-            throw std::runtime_error("Invalid RIFF format for wave_file '" + m_path.string() + "'");
+            m_handle = std::make_shared<const detail::file_handle>(m_path);
         }
 
-        header format_header{};
-        file.read(reinterpret_cast<char*>(&format_header), sizeof(format_header));
-        if (std::strncmp(format_header.id, "fmt ", sizeof(format_header.id)))
+        return m_handle;
+    }
+
+    // Opens a reader that only uses state that was set up before any const read, so any number of
+    // threads can open and use one at once
+    wave_reader<T> shared_reader() const
+    {
+        assert(m_initialized);
+
+        if (m_in_memory)
         {
-            throw std::runtime_error("Invalid fmt header for wave_file '" + m_path.string() + "'");
+            return wave_reader<T>(m_path, m_mapping, m_layout, m_stats);
         }
 
-        format_chunk format_chunk{};
-        file.read(reinterpret_cast<char*>(&format_chunk), sizeof(format_chunk));
-        size_t format_bytes_read = sizeof(format_chunk);
-        if (file.fail())
+        if (!m_handle || !m_handle->is_open())
         {
-            throw std::runtime_error("Error reading format chunk for wave_file '" + m_path.string()
-                                     + "'");
+            throw std::runtime_error("Failed to open wave_file '" + m_path.string() + "'");
         }
 
-        m_sample_rate = format_chunk.sample_rate;
-        m_channels    = format_chunk.channels;
+        return wave_reader<T>(m_path, m_handle, m_layout, m_stats);
+    }
 
-        switch (format_chunk.format)
+    // Gets the reader used for reads that aren't split over threads, opening it first if necessary.
+    // It is kept between calls so its buffers are only allocated once.
+    wave_reader<T>& reader()
+    {
+        if (!m_reader)
         {
-            case wave_format::pcm:
-            {
-                m_format = wave_format::pcm;
-
-                // Read PCM format extension
-                format_ext_pcm format_ext{};
-                file.read(reinterpret_cast<char*>(&format_ext), sizeof(format_ext));
-                if (file.fail())
-                {
-                    throw std::runtime_error("Error reading PCM format extension for wave_file '"
-                                             + m_path.string() + "'");
-                }
+            m_reader.emplace(this->open_reader());
+        }
 
-                format_bytes_read += sizeof(format_ext);
+        return *m_reader;
+    }
 
-                switch (format_ext.bits_per_sample)
-                {
-                    case 8:
-                    {
-                        m_data_type = wave_subformat::pcm_uint8;
-                        break;
-                    }
-                    case 16:
-                    {
-                        m_data_type = wave_subformat::pcm_int16;
-                        break;
-                    }
-                    case 24:
-                    {
-                        m_data_type = wave_subformat::pcm_int24;
-                        break;
-                    }
-                    case 32:
-                    {
-                        m_data_type = wave_subformat::pcm_int32;
-                        break;
-                    }
-                    default:
-                    {
-                        throw std::runtime_error("Invalid PCM subformat for wave_file '"
-                                                 + m_path.string() + "'");
-                    }
-                }
+    // Gets the mapping of the file, mapping it first if necessary
+    const std::shared_ptr<const detail::mapped_file>& mapping()
+    {
+        if (!m_mapping)
+        {
+            m_mapping = std::make_shared<const detail::mapped_file>(m_path);
+        }
 
-                break;
-            }
-            case wave_format::ieee_float:
-            {
-                m_format = wave_format::ieee_float;
+        return m_mapping;
+    }
 
-                // Read IEEE float format extension
-                format_ext_ieee_float format_ext{};
-                file.read(reinterpret_cast<char*>(&format_ext), sizeof(format_ext));
-                if (file.fail())
-                {
-                    throw std::runtime_error(
-                        "Error reading IEEE float format extension for wave_file '"
-                        + m_path.string() + "'");
-                }
+    const detail::wave_layout& layout() const
+    {
+        return m_layout;
+    }
 
-                format_bytes_read += sizeof(format_ext);
+    void initialize()
+    {
+        const detail::scoped_trace trace("parse_header", m_path);
+        const auto                 start = std::chrono::steady_clock::now();
 
-                switch (format_ext.bits_per_sample)
+        if (m_in_memory)
+        {
+            const auto& memory = *m_mapping;
+            const auto  read   = [this, &memory](size_t offset, std::byte* data, size_t size) {
+                if (offset > memory.size() || size > memory.size() - offset)
                 {
-                    case 32:
-                    {
-                        m_data_type = wave_subformat::ieee_float32;
-                        break;
-                    }
-                    case 64:
-                    {
-                        m_data_type = wave_subformat::ieee_float64;
-                        break;
-                    }
-                    default:
-                    {
-                        throw std::runtime_error("Invalid IEEE float subformat for wave_file '"
-                                                 + m_path.string() + "'");
-                    }
+                    return false;
                 }
 
-                break;
-            }
-            default:
-            {
-                std::stringstream format_stream;
-                format_stream << std::hex << format_chunk.format;
-                throw std::runtime_error("Invalid format '" + format_stream.str()
-                                         + "' for wave_file '" + m_path.string() + "'");
-            }
-        }
+                std::memcpy(data, memory.data() + offset, size);
+                m_open_stats.bytes_read += size;
+                return true;
+            };
 
-        // Ignore any extra data at the end of the format chunk
-        if (format_header.size != format_bytes_read)
-        {
-            file.ignore(format_header.size - format_bytes_read);
-            if (file.fail())
-            {
-                throw std::runtime_error("Unexpected fmt chunk size for wave_file '"
-                                         + m_path.string() + "'");
-            }
+            m_layout = detail::parse_header(m_path, read);
         }
-
-        // Keep reading until the start of the data chunk
-        while (!file.eof())
+        else
         {
-            header current_header{};
-            file.read(reinterpret_cast<char*>(&current_header), sizeof(current_header));
-            if (file.fail())
+            const auto& handle = this->handle();
+            if (!handle->is_open())
             {
-                throw std::runtime_error("Invalid chunk header found in wave_file '"
-                                         + m_path.string() + "'");
+                throw std::runtime_error("Failed to open wave_file '" + m_path.string() + "'");
             }
 
-            if (!std::strncmp(current_header.id, "data", 4))
-            {
-                m_data_position = file.tellg();
-                m_size          = current_header.size / format_chunk.block_align;
-                m_initialized   = true;
-                break;
-            }
+            const auto read = [this, &handle](size_t offset, std::byte* data, size_t size) {
+                m_open_stats.bytes_read += size;
+                ++m_open_stats.read_calls;
+                return handle->read_at(offset, data, size);
+            };
 
-            file.ignore(current_header.size);
-            if (file.fail())
-            {
-                if (file.eof())
-                {
-                    throw std::runtime_error("Unexpected EOF for wave_file '" + m_path.string()
-                                             + "'");
-                }
-                else
-                {
-                    throw std::runtime_error("Failed to ignore chunk "
-                                             + std::string(current_header.id) + " in wave_file '"
-                                             + m_path.string() + "'");
-                }
-            }
+            m_layout = detail::parse_header(m_path, read);
         }
 
-        if (!m_initialized)
-        {
-            throw std::runtime_error("Failed to initialize wave_file '" + m_path.string() + "'");
-        }
+        m_open_stats.header_time = std::chrono::steady_clock::now() - start;
+        m_initialized            = true;
     }
 
-// Do NOT allow padding of the structures used for reading data
-#pragma pack(push, 1)
-    struct header
-    {
-        char     id[4];
-        uint32_t size;
-    };
+    std::filesystem::path m_path;
+    detail::wave_layout   m_layout;
+    bool                  m_initialized;
+    wave_read_mode        m_read_mode;
+    size_t                m_threads;
+    bool                  m_in_memory;
 
-    struct format_chunk
-    {
-        uint16_t format;
-        uint16_t channels;
-        uint32_t sample_rate;
-        uint32_t byte_rate;
-        uint16_t block_align;
-    };
+    // Kept open across calls and shared with readers
+    std::shared_ptr<const detail::file_handle> m_handle;
 
-    struct format_ext_pcm
-    {
-        uint16_t bits_per_sample;
-    };
+    // Shared so channel views can keep the mapping alive
+    std::shared_ptr<const detail::mapped_file> m_mapping;
 
-    struct format_ext_ieee_float
-    {
-        uint16_t bits_per_sample;
+    // Reused by every read that isn't split over threads
+    std::optional<wave_reader<T>> m_reader;
 
-        // The internet suggests this extra field should exist, but in practice it is sometimes
-        // missing
-        // uint16_t extension_size;
-    };
-#pragma pack(pop)
+    // Counters shared with readers and writers (null while stats are disabled)
+    std::shared_ptr<detail::stats_counters> m_stats;
 
-    std::filesystem::path m_path;
-    wave_format           m_format;
-    wave_subformat        m_data_type;
-    size_t                m_sample_rate;
-    size_t                m_size;
-    size_t                m_channels;
-    std::streampos        m_data_position;
-    bool                  m_initialized;
+    // Parsing the header happens before stats can be enabled, so its cost is always kept
+    file_stats m_open_stats;
+    file_stats m_last_stats;
 };
 
 }  // namespace tnt::audio
@@ -0,0 +1,43 @@
+#pragma once
+
+namespace tnt::audio
+{
+
+/*!
+\brief Represents valid wave file formats
+*/
+enum class wave_format
+{
+    pcm        = 0x0001,
+    ieee_float = 0x0003,
+};
+
+/*!
+\brief Represents valid wave file subformats
+*/
+enum class wave_subformat
+{
+    pcm_uint8,
+    pcm_int16,
+    pcm_int24,
+    pcm_int32,
+    ieee_float32,
+    ieee_float64,
+};
+
+/*!
+\brief Represents the ways sample data can be read from a wave file
+*/
+enum class wave_read_mode
+{
+    // Read sequentially on every call
+    stream,
+
+    // Map the file into memory once and decode directly from the mapping
+    mapped,
+
+    // Split the frames into ranges and decode them concurrently using positional reads
+    parallel,
+};
+
+}  // namespace tnt::audio
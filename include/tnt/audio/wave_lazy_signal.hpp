@@ -0,0 +1,240 @@
+#pragma once
+
+#include "multisignal.hpp"
+#include "wave_reader.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace tnt::audio
+{
+
+/*!
+\brief Read only multi-channel signal whose sample data is decoded from a wave file on first access
+
+The sample data is decoded a page of frames at a time, and only the most recently used pages are
+kept, so memory use is bounded no matter how long the file is. Getting the shape of the signal
+doesn't decode anything. Views are created with wave_file::read_lazy(). A view is not thread safe,
+since every access may update its page cache.
+*/
+template <typename T>
+class wave_lazy_signal final
+{
+public:
+    /*!
+    \brief Read only frame of the signal
+
+    A frame keeps the page it belongs to alive, so it stays valid after the page is evicted.
+    */
+    class frame final
+    {
+    public:
+        /*!
+        \brief Gets the number of channels in the frame
+        \return Size
+        */
+        size_t size() const
+        {
+            return m_page->channels();
+        }
+
+        /*!
+        \brief Gets a sample from the frame
+        \param[in] c Index of the channel
+        \return Sample
+        */
+        T operator[](size_t c) const
+        {
+            return (*m_page)[m_index][c];
+        }
+
+    private:
+        friend class wave_lazy_signal;
+
+        frame(std::shared_ptr<const multisignal<T>> page, size_t index)
+            : m_page(std::move(page))
+            , m_index(index)
+        {}
+
+        std::shared_ptr<const multisignal<T>> m_page;
+        size_t                                m_index;
+    };
+
+    /*!
+    \brief Constructor
+    \param[in] reader Reader of the sample data (only used to decode pages)
+    \param[in] page_frames Number of frames decoded at a time
+    \param[in] cache_pages Maximum number of decoded pages kept
+    */
+    wave_lazy_signal(wave_reader<T> reader, size_t page_frames, size_t cache_pages)
+        : m_reader(std::move(reader))
+        , m_page_frames(page_frames)
+        , m_cache_pages(cache_pages)
+        , m_pages()
+        , m_recent()
+        , m_last_index()
+        , m_last_page()
+    {
+        if (m_page_frames == 0 || m_cache_pages == 0)
+        {
+            throw std::invalid_argument("Page size and page count of wave_lazy_signal must be "
+                                        "nonzero");
+        }
+    }
+
+    /*!
+    \brief Gets the sample rate of the signal
+    \return Sample Rate
+    */
+    size_t sample_rate() const
+    {
+        return m_reader.sample_rate();
+    }
+
+    /*!
+    \brief Gets the number of frames in the signal
+    \return Size
+    */
+    size_t size() const
+    {
+        return m_reader.size();
+    }
+
+    /*!
+    \brief Gets the number of channels in the signal
+    \return Channels
+    */
+    size_t channels() const
+    {
+        return m_reader.channels();
+    }
+
+    /*!
+    \brief Gets the number of frames decoded at a time
+    \return Page Frames
+    */
+    size_t page_frames() const
+    {
+        return m_page_frames;
+    }
+
+    /*!
+    \brief Gets the maximum number of decoded pages kept
+    \return Cache Pages
+    */
+    size_t cache_pages() const
+    {
+        return m_cache_pages;
+    }
+
+    /*!
+    \brief Gets the number of decoded pages currently kept
+    \return Cached Pages
+    */
+    size_t cached_pages() const
+    {
+        return m_pages.size();
+    }
+
+    /*!
+    \brief Gets a frame of the signal, decoding its page if it isn't cached
+    \param[in] n Index of the frame
+    \return Frame
+    */
+    frame operator[](size_t n) const
+    {
+        assert(n < this->size());
+        return frame(this->page(n / m_page_frames), n % m_page_frames);
+    }
+
+    /*!
+    \brief Gets a sample of the signal, decoding its page if it isn't cached
+    \param[in] n Index of the frame
+    \param[in] c Index of the channel
+    \return Sample
+    */
+    T at(size_t n, size_t c) const
+    {
+        if (n >= this->size() || c >= this->channels())
+        {
+            throw std::out_of_range("Invalid sample index for wave_lazy_signal");
+        }
+
+        return (*this->page(n / m_page_frames))[n % m_page_frames][c];
+    }
+
+private:
+    struct cached_page
+    {
+        std::shared_ptr<const multisignal<T>> page;
+        typename std::list<size_t>::iterator  recent;
+    };
+
+    // Gets a page, decoding it first if it isn't cached and evicting the least recently used page
+    // if the cache is full
+    const std::shared_ptr<const multisignal<T>>& page(size_t index) const
+    {
+        // Consecutive accesses mostly fall on the same page, so skip the lookup for those
+        if (m_last_page && m_last_index == index)
+        {
+            return m_last_page;
+        }
+
+        auto cached = m_pages.find(index);
+        if (cached != m_pages.end())
+        {
+            m_recent.splice(m_recent.begin(), m_recent, cached->second.recent);
+        }
+        else
+        {
+            if (m_pages.size() == m_cache_pages)
+            {
+                // Drop the shortcut to the evicted page too, so it isn't kept past the cache bound
+                const auto evicted = m_recent.back();
+                if (evicted == m_last_index)
+                {
+                    m_last_page.reset();
+                }
+
+                m_pages.erase(evicted);
+                m_recent.pop_back();
+            }
+
+            const auto start = index * m_page_frames;
+            const auto count = std::min(m_page_frames, this->size() - start);
+
+            auto page = std::make_shared<multisignal<T>>(this->sample_rate(),
+                                                         count,
+                                                         this->channels());
+            m_reader.seek(start);
+            if (m_reader.read(*page) != count)
+            {
+                throw std::runtime_error("Failed to decode page of wave_lazy_signal");
+            }
+
+            m_recent.push_front(index);
+            cached = m_pages.emplace(index, cached_page{std::move(page), m_recent.begin()}).first;
+        }
+
+        m_last_index = index;
+        m_last_page  = cached->second.page;
+        return m_last_page;
+    }
+
+    mutable wave_reader<T>                          m_reader;
+    size_t                                          m_page_frames;
+    size_t                                          m_cache_pages;
+    mutable std::unordered_map<size_t, cached_page> m_pages;
+    mutable std::list<size_t>                       m_recent;
+    mutable size_t                                  m_last_index;
+    mutable std::shared_ptr<const multisignal<T>>   m_last_page;
+};
+
+}  // namespace tnt::audio
@@ -0,0 +1,560 @@
+#pragma once
+
+#include "multisignal.hpp"
+#include "wave_file.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace tnt::audio
+{
+
+/*!
+\brief Summary of the samples of one channel over a range of frames
+*/
+struct overview_bucket
+{
+    float min;
+    float max;
+    float rms;
+};
+
+namespace detail
+{
+
+// Do NOT allow padding of the structures used for reading data
+#pragma pack(push, 1)
+// Start of an overview sidecar file, followed by the buckets of each level in turn
+struct overview_header
+{
+    char     id[4];
+    uint32_t version;
+
+    // Identity of the wave file the overview was built from
+    uint64_t file_size;
+    int64_t  file_time;
+
+    uint64_t sample_rate;
+    uint64_t size;
+    uint64_t channels;
+    uint64_t base_frames;
+    uint64_t factor;
+    uint64_t levels;
+};
+#pragma pack(pop)
+
+inline constexpr uint32_t overview_version = 1;
+
+// Size and modification time of a file, which change whenever the file is rewritten
+inline std::optional<std::pair<uint64_t, int64_t>> file_identity(const std::filesystem::path& path)
+{
+    std::error_code error{};
+    const auto      size = std::filesystem::file_size(path, error);
+    if (error)
+    {
+        return std::nullopt;
+    }
+
+    const auto time = std::filesystem::last_write_time(path, error);
+    if (error)
+    {
+        return std::nullopt;
+    }
+
+    return std::make_pair(static_cast<uint64_t>(size),
+                          static_cast<int64_t>(time.time_since_epoch().count()));
+}
+
+// Gets the number of frames per bucket of a level (only valid for levels kept by overview_levels())
+inline size_t overview_frames(size_t base_frames, size_t factor, size_t level)
+{
+    auto frames = base_frames;
+    for (size_t i = 0; i < level; ++i)
+    {
+        frames *= factor;
+    }
+
+    return frames;
+}
+
+// Gets the number of buckets needed to cover a number of frames
+inline size_t overview_buckets(size_t size, size_t frames)
+{
+    return size / frames + (size % frames != 0);
+}
+
+// Gets the number of levels worth keeping out of those requested. Levels stop once a single bucket
+// covers the whole file, since coarser levels would only repeat it, which also keeps the frames per
+// bucket from overflowing. Requires base_frames > 0 and factor > 1.
+inline size_t overview_levels(size_t size, size_t base_frames, size_t factor, size_t levels)
+{
+    size_t count  = 1;
+    size_t frames = base_frames;
+    while (count < levels && frames < size && frames <= std::numeric_limits<size_t>::max() / factor)
+    {
+        frames *= factor;
+        ++count;
+    }
+
+    return count;
+}
+
+// Multiplies two sizes, giving nothing if the product doesn't fit
+inline std::optional<uint64_t> checked_multiply(uint64_t a, uint64_t b)
+{
+    if (a != 0 && b > std::numeric_limits<uint64_t>::max() / a)
+    {
+        return std::nullopt;
+    }
+
+    return a * b;
+}
+
+// Running summary of a bucket that is still being filled
+struct overview_accumulator
+{
+    float  min = std::numeric_limits<float>::max();
+    float  max = std::numeric_limits<float>::lowest();
+    double sum_squares{};
+    size_t frames{};
+
+    void merge(const overview_accumulator& other)
+    {
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+        sum_squares += other.sum_squares;
+        frames += other.frames;
+    }
+
+    overview_bucket bucket() const
+    {
+        return {min, max, static_cast<float>(std::sqrt(sum_squares / frames))};
+    }
+};
+
+}  // namespace detail
+
+/*!
+\brief Min, max and RMS of a wave file at several resolutions
+
+Level 0 summarizes every base_frames frames of each channel and every following level summarizes
+factor buckets of the one before, so a waveform of any zoom can be drawn from the level closest to
+the number of frames per pixel without touching the audio data. All levels are built in a single
+pass over the file and can be cached in a sidecar file next to it.
+*/
+class wave_overview final
+{
+public:
+    /*!
+    \brief Builds the overview of a wave file by reading it once from start to end
+    \param[in] file Wave file to summarize
+    \param[in] base_frames Number of frames per bucket of level 0
+    \param[in] factor Number of buckets of a level summarized by each bucket of the next level
+    \param[in] levels Maximum number of levels (none are added after a level with a single bucket)
+    \return Overview
+    */
+    template <typename T>
+    static wave_overview build(wave_file<T>& file,
+                               size_t        base_frames = 256,
+                               size_t        factor      = 4,
+                               size_t        levels      = 8)
+    {
+        if (base_frames == 0 || factor < 2 || levels == 0)
+        {
+            throw std::invalid_argument("Invalid decimation for wave_overview");
+        }
+
+        auto reader = file.open_reader();
+
+        const auto channels = reader.channels();
+
+        levels = detail::overview_levels(reader.size(), base_frames, factor, levels);
+
+        wave_overview overview(reader.sample_rate(),
+                               reader.size(),
+                               channels,
+                               base_frames,
+                               factor,
+                               levels);
+
+        // One bucket of each level is filled at a time, a full bucket is stored and merged into the
+        // bucket of the next level
+        std::vector<std::vector<detail::overview_accumulator>> accumulators(
+            levels, std::vector<detail::overview_accumulator>(channels));
+
+        // The bucket sizes are checked after every frame, so they're only computed once
+        std::vector<size_t> bucket_frames(levels);
+        for (size_t level = 0; level < levels; ++level)
+        {
+            bucket_frames[level] = overview.frames_per_bucket(level);
+        }
+
+        const auto store = [&](size_t level) {
+            for (size_t c = 0; c < channels; ++c)
+            {
+                overview.m_levels[level].push_back(accumulators[level][c].bucket());
+                if (level + 1 < levels)
+                {
+                    accumulators[level + 1][c].merge(accumulators[level][c]);
+                }
+
+                accumulators[level][c] = {};
+            }
+        };
+
+        multisignal<T> block(reader.sample_rate(), block_frames, channels);
+        while (const auto frames = reader.read(block))
+        {
+            for (size_t n = 0; n < frames; ++n)
+            {
+                auto&& frame = block[n];
+                for (size_t c = 0; c < channels; ++c)
+                {
+                    const auto sample      = static_cast<float>(frame[c]);
+                    auto&      accumulator = accumulators[0][c];
+
+                    accumulator.min = std::min(accumulator.min, sample);
+                    accumulator.max = std::max(accumulator.max, sample);
+                    accumulator.sum_squares += static_cast<double>(sample) * sample;
+                    ++accumulator.frames;
+                }
+
+                // Store every bucket completed by this frame, from the finest level up
+                for (size_t level = 0; level < levels; ++level)
+                {
+                    if (accumulators[level][0].frames < bucket_frames[level])
+                    {
+                        break;
+                    }
+
+                    store(level);
+                }
+            }
+        }
+
+        // The last bucket of each level may be partial
+        for (size_t level = 0; level < levels; ++level)
+        {
+            if (accumulators[level][0].frames != 0)
+            {
+                store(level);
+            }
+        }
+
+        return overview;
+    }
+
+    /*!
+    \brief Gets the overview of a wave file from its sidecar, building and saving it if the sidecar
+    is missing, out of date or uses a different decimation
+    \param[in] path Path to the wave file on the system
+    \param[in] sidecar Path to the sidecar file caching the overview
+    \param[in] base_frames Number of frames per bucket of level 0
+    \param[in] factor Number of buckets of a level summarized by each bucket of the next level
+    \param[in] levels Maximum number of levels (none are added after a level with a single bucket)
+    \return Overview
+    */
+    static wave_overview open(const std::filesystem::path& path,
+                              const std::filesystem::path& sidecar,
+                              size_t                       base_frames = 256,
+                              size_t                       factor      = 4,
+                              size_t                       levels      = 8)
+    {
+        if (auto overview = load(sidecar, path))
+        {
+            // The decimation of a loaded overview is valid, so the levels can only be compared once
+            // the rest of the decimation is known to match
+            if (overview->m_base_frames == base_frames && overview->m_factor == factor
+                && overview->levels()
+                       == detail::overview_levels(overview->m_size, base_frames, factor, levels))
+            {
+                return std::move(*overview);
+            }
+        }
+
+        wave_file<float> file(path);
+        auto             overview = build(file, base_frames, factor, levels);
+        overview.save(sidecar, path);
+
+        return overview;
+    }
+
+    /*!
+    \brief Loads an overview from a sidecar file
+    \param[in] sidecar Path to the sidecar file
+    \param[in] path Path to the wave file the overview was built from
+    \return Overview, or nothing if the sidecar is missing, invalid or older than the wave file
+    */
+    static std::optional<wave_overview> load(const std::filesystem::path& sidecar,
+                                             const std::filesystem::path& path)
+    {
+        const auto identity = detail::file_identity(path);
+        if (!identity)
+        {
+            return std::nullopt;
+        }
+
+        std::ifstream file(sidecar, std::ios::binary);
+
+        detail::overview_header header{};
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))
+            || std::memcmp(header.id, "TNTO", 4) != 0 || header.version != detail::overview_version
+            || header.file_size != identity->first || header.file_time != identity->second
+            || header.base_frames == 0 || header.factor < 2 || header.channels == 0
+            || header.levels
+                   != detail::overview_levels(header.size,
+                                              header.base_frames,
+                                              header.factor,
+                                              header.levels))
+        {
+            return std::nullopt;
+        }
+
+        // Check the size before allocating anything so a damaged header can't request huge buffers
+        uint64_t expected_size = sizeof(header);
+        for (size_t level = 0; level < header.levels; ++level)
+        {
+            const auto frames  = detail::overview_frames(header.base_frames, header.factor, level);
+            const auto buckets = detail::overview_buckets(header.size, frames);
+            const auto count   = detail::checked_multiply(buckets, header.channels);
+            const auto bytes   = count ? detail::checked_multiply(*count, sizeof(overview_bucket))
+                                       : std::nullopt;
+
+            if (!bytes || *bytes > std::numeric_limits<uint64_t>::max() - expected_size)
+            {
+                return std::nullopt;
+            }
+
+            expected_size += *bytes;
+        }
+
+        std::error_code error{};
+        if (std::filesystem::file_size(sidecar, error) != expected_size || error)
+        {
+            return std::nullopt;
+        }
+
+        wave_overview overview(header.sample_rate,
+                               header.size,
+                               header.channels,
+                               header.base_frames,
+                               header.factor,
+                               header.levels);
+
+        for (size_t level = 0; level < overview.levels(); ++level)
+        {
+            auto& buckets = overview.m_levels[level];
+            buckets.resize(overview.buckets(level) * overview.m_channels);
+            if (!file.read(reinterpret_cast<char*>(buckets.data()),
+                           static_cast<std::streamsize>(buckets.size() * sizeof(overview_bucket))))
+            {
+                return std::nullopt;
+            }
+        }
+
+        return overview;
+    }
+
+    /*!
+    \brief Saves the overview to a sidecar file
+    \param[in] sidecar Path to the sidecar file
+    \param[in] path Path to the wave file the overview was built from
+    */
+    void save(const std::filesystem::path& sidecar, const std::filesystem::path& path) const
+    {
+        const auto identity = detail::file_identity(path);
+        if (!identity)
+        {
+            throw std::runtime_error("Failed to read the size of wave_file '" + path.string()
+                                     + "'");
+        }
+
+        detail::overview_header header{};
+        std::memcpy(header.id, "TNTO", 4);
+        header.version     = detail::overview_version;
+        header.file_size   = identity->first;
+        header.file_time   = identity->second;
+        header.sample_rate = m_sample_rate;
+        header.size        = m_size;
+        header.channels    = m_channels;
+        header.base_frames = m_base_frames;
+        header.factor      = m_factor;
+        header.levels      = m_levels.size();
+
+        std::ofstream file(sidecar, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const auto& buckets : m_levels)
+        {
+            file.write(reinterpret_cast<const char*>(buckets.data()),
+                       static_cast<std::streamsize>(buckets.size() * sizeof(overview_bucket)));
+        }
+
+        if (!file)
+        {
+            throw std::runtime_error("Failed to write wave_overview '" + sidecar.string() + "'");
+        }
+    }
+
+    /*!
+    \brief Gets the sample rate of the wave file
+    \return Sample Rate
+    */
+    size_t sample_rate() const
+    {
+        return m_sample_rate;
+    }
+
+    /*!
+    \brief Gets the number of frames in the wave file
+    \return Size
+    */
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    /*!
+    \brief Gets the number of channels in the wave file
+    \return Channels
+    */
+    size_t channels() const
+    {
+        return m_channels;
+    }
+
+    /*!
+    \brief Gets the number of levels
+    \return Levels
+    */
+    size_t levels() const
+    {
+        return m_levels.size();
+    }
+
+    /*!
+    \brief Gets the number of frames summarized by each bucket of a level
+    \param[in] level Level (zero is the finest)
+    \return Frames per bucket
+    */
+    size_t frames_per_bucket(size_t level) const
+    {
+        if (level >= this->levels())
+        {
+            throw std::out_of_range("Invalid level for wave_overview");
+        }
+
+        return detail::overview_frames(m_base_frames, m_factor, level);
+    }
+
+    /*!
+    \brief Gets the number of buckets of each channel at a level
+    \param[in] level Level (zero is the finest)
+    \return Buckets
+    */
+    size_t buckets(size_t level) const
+    {
+        return detail::overview_buckets(m_size, this->frames_per_bucket(level));
+    }
+
+    /*!
+    \brief Finds the coarsest level with buckets no larger than a number of frames
+    \param[in] frames Maximum number of frames per bucket (for example the frames per pixel)
+    \return Level
+    */
+    size_t level_for(size_t frames) const
+    {
+        size_t level = 0;
+        while (level + 1 < this->levels() && this->frames_per_bucket(level + 1) <= frames)
+        {
+            ++level;
+        }
+
+        return level;
+    }
+
+    /*!
+    \brief Gets the buckets of a level covering a range of frames of one channel
+    \param[in] level Level (zero is the finest)
+    \param[in] start_frame First frame of the range
+    \param[in] frame_count Number of frames in the range (clamped to the end of the file)
+    \param[in] channel Channel to summarize
+    \return Buckets overlapping the range in order
+    */
+    std::vector<overview_bucket> query(size_t level,
+                                       size_t start_frame,
+                                       size_t frame_count,
+                                       size_t channel) const
+    {
+        if (level >= this->levels())
+        {
+            throw std::out_of_range("Invalid level for wave_overview");
+        }
+
+        if (channel >= m_channels)
+        {
+            throw std::out_of_range("Invalid channel for wave_overview");
+        }
+
+        if (start_frame > m_size)
+        {
+            throw std::out_of_range("Invalid start frame for wave_overview");
+        }
+
+        const auto frames = this->frames_per_bucket(level);
+        const auto end    = start_frame + std::min(frame_count, m_size - start_frame);
+        const auto first  = start_frame / frames;
+        const auto last   = end == start_frame ? first : (end + frames - 1) / frames;
+
+        const auto& buckets = m_levels[level];
+
+        std::vector<overview_bucket> result;
+        result.reserve(last - first);
+        for (size_t b = first; b < last; ++b)
+        {
+            result.push_back(buckets[b * m_channels + channel]);
+        }
+
+        return result;
+    }
+
+private:
+    // Frames read from the file at a time while building
+    static constexpr size_t block_frames = 16384;
+
+    wave_overview(size_t sample_rate,
+                  size_t size,
+                  size_t channels,
+                  size_t base_frames,
+                  size_t factor,
+                  size_t levels)
+        : m_sample_rate(sample_rate)
+        , m_size(size)
+        , m_channels(channels)
+        , m_base_frames(base_frames)
+        , m_factor(factor)
+        , m_levels(levels)
+    {
+    }
+
+    size_t m_sample_rate;
+    size_t m_size;
+    size_t m_channels;
+    size_t m_base_frames;
+    size_t m_factor;
+
+    // Buckets of each level, all channels of a bucket next to each other
+    std::vector<std::vector<overview_bucket>> m_levels;
+};
+
+}  // namespace tnt::audio
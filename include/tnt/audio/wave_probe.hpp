@@ -0,0 +1,110 @@
+#pragma once
+
+#include "detail/file_handle.hpp"
+#include "detail/parallel.hpp"
+#include "detail/wave_header.hpp"
+#include "wave_format.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace tnt::audio
+{
+
+/*!
+\brief Metadata of a wave file read from its header
+*/
+struct wave_info
+{
+    // Path to the wave file on the system
+    std::filesystem::path path;
+
+    // Description of why the header couldn't be read (empty on success)
+    std::string error;
+
+    wave_subformat subformat;
+    size_t         sample_rate;
+    size_t         channels;
+    size_t         size;
+    double         duration;
+};
+
+namespace detail
+{
+
+// Headers almost always fit in one small read, anything past it is read on demand
+inline constexpr size_t probe_size = 4096;
+
+inline wave_info probe_wave_file(const std::filesystem::path& path)
+{
+    wave_info info{};
+    info.path = path;
+
+    try
+    {
+        const file_handle handle(path);
+        if (!handle.is_open())
+        {
+            throw std::runtime_error("Failed to open wave_file '" + path.string() + "'");
+        }
+
+        std::array<std::byte, probe_size> prefix{};
+        const auto prefix_size = handle.read_some_at(0, prefix.data(), prefix.size());
+
+        const auto read = [&](size_t offset, std::byte* data, size_t size) {
+            if (offset + size <= prefix_size)
+            {
+                std::memcpy(data, prefix.data() + offset, size);
+                return true;
+            }
+
+            return handle.read_at(offset, data, size);
+        };
+
+        const auto layout = parse_header(path, read);
+
+        info.subformat   = layout.subformat;
+        info.sample_rate = layout.sample_rate;
+        info.channels    = layout.channels;
+        info.size        = layout.size;
+        info.duration    = layout.size / static_cast<double>(layout.sample_rate);
+    }
+    catch (const std::exception& e)
+    {
+        info.error = e.what();
+    }
+
+    return info;
+}
+
+}  // namespace detail
+
+/*!
+\brief Reads the metadata of many wave files concurrently
+
+Only the header of each file is read (usually with a single small read), so this is much cheaper
+than constructing a wave_file for each path. A file that can't be read doesn't stop the others, its
+error is reported in its result instead.
+
+\param[in] paths Paths to the wave files on the system
+\param[in] threads Number of threads to use (zero uses one per hardware thread)
+\return Metadata of each file in the same order as the paths
+*/
+inline std::vector<wave_info> probe_wave_files(const std::vector<std::filesystem::path>& paths,
+                                               size_t threads = 0)
+{
+    std::vector<wave_info> infos(paths.size());
+    detail::parallel_for(paths.size(), threads, [&](size_t i) {
+        infos[i] = detail::probe_wave_file(paths[i]);
+    });
+
+    return infos;
+}
+
+}  // namespace tnt::audio
@@ -0,0 +1,343 @@
+#pragma once
+
+#include "detail/file_handle.hpp"
+#include "detail/mapped_file.hpp"
+#include "detail/wave.hpp"
+#include "file_stats.hpp"
+#include "multisignal.hpp"
+#include "sample_codec.hpp"
+#include "trace.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace tnt::audio
+{
+
+/*!
+\brief Reads the audio data of a wave file a block of frames at a time
+
+Only one block of frames is held in memory at a time, so files of any length can be processed with
+constant memory. Readers are created with wave_file::open_reader().
+*/
+template <typename T>
+class wave_reader final
+{
+public:
+    /*!
+    \brief Constructor (opens its own handle to the file)
+    \param[in] path Path to the wave file on the system
+    \param[in] layout Location and shape of the sample data in the file
+    */
+    wave_reader(const std::filesystem::path& path, const detail::wave_layout& layout)
+        : wave_reader(path, std::make_shared<const detail::file_handle>(path), layout)
+    {}
+
+    /*!
+    \brief Constructor (reads at explicit offsets through a handle that may be shared)
+    \param[in] path Path to the wave file on the system
+    \param[in] handle Open handle to the file
+    \param[in] layout Location and shape of the sample data in the file
+    \param[in] stats Counters to record the work done in (null to not record it)
+    */
+    wave_reader(const std::filesystem::path&               path,
+                std::shared_ptr<const detail::file_handle> handle,
+                const detail::wave_layout&                 layout,
+                std::shared_ptr<detail::stats_counters>    stats = nullptr)
+        : m_path(path)
+        , m_layout(layout)
+        , m_position()
+        , m_handle(std::move(handle))
+        , m_mapping()
+        , m_stats(std::move(stats))
+        , m_buffer()
+        , m_samples()
+    {
+        if (!m_handle->is_open())
+        {
+            throw std::runtime_error("Failed to open wave_file '" + m_path.string()
+                                     + "' for reading");
+        }
+    }
+
+    /*!
+    \brief Constructor (decodes directly from a memory mapping of the file)
+    \param[in] path Path to the wave file on the system
+    \param[in] mapping Mapping of the whole file
+    \param[in] layout Location and shape of the sample data in the file
+    \param[in] stats Counters to record the work done in (null to not record it)
+    */
+    wave_reader(const std::filesystem::path&               path,
+                std::shared_ptr<const detail::mapped_file> mapping,
+                const detail::wave_layout&                 layout,
+                std::shared_ptr<detail::stats_counters>    stats = nullptr)
+        : m_path(path)
+        , m_layout(layout)
+        , m_position()
+        , m_handle()
+        , m_mapping(std::move(mapping))
+        , m_stats(std::move(stats))
+        , m_buffer()
+        , m_samples()
+    {
+        if (m_mapping->size() < m_layout.data_position + m_layout.size * this->block_align())
+        {
+            throw std::runtime_error("Unexpected EOF for wave_file '" + m_path.string() + "'");
+        }
+    }
+
+    /*!
+    \brief Gets the sample rate of the encoded audio data
+    \return Sample Rate
+    */
+    size_t sample_rate() const
+    {
+        return m_layout.sample_rate;
+    }
+
+    /*!
+    \brief Gets the number of frames in the file
+    \return Size
+    */
+    size_t size() const
+    {
+        return m_layout.size;
+    }
+
+    /*!
+    \brief Gets the number of channels contained in the file
+    \return Channels
+    */
+    size_t channels() const
+    {
+        return m_layout.channels;
+    }
+
+    /*!
+    \brief Gets the index of the next frame to be read
+    \return Position
+    */
+    size_t position() const
+    {
+        return m_position;
+    }
+
+    /*!
+    \brief Moves to the given frame so it is the next frame to be read
+    \param[in] frame Index of the frame (clamped to the end of the file)
+    */
+    void seek(size_t frame)
+    {
+        m_position = std::min(frame, m_layout.size);
+    }
+
+    /*!
+    \brief Reads the next frames of audio data into a block
+
+    Fills the block from its first frame with as many frames as it can hold or as are left in the
+    file. Any remaining frames of the block are left untouched.
+
+    \param[out] block Multi-channel signal with the same number of channels as the file
+    \return Number of frames read (zero once the end of the file is reached)
+    */
+    size_t read(multisignal<T>& block)
+    {
+        return this->read(block, 0, block.size());
+    }
+
+    /*!
+    \brief Reads the next frames of audio data into part of a block
+    \param[out] block Multi-channel signal with the same number of channels as the file
+    \param[in] offset Frame of the block to store the first frame read in
+    \param[in] frames Maximum number of frames to read (clamped to the end of the block)
+    \return Number of frames read (zero once the end of the file is reached)
+    */
+    size_t read(multisignal<T>& block, size_t offset, size_t frames)
+    {
+        if (block.channels() != m_layout.channels)
+        {
+            throw std::invalid_argument("Block channel count does not match wave_file '"
+                                        + m_path.string() + "'");
+        }
+
+        return this->read_frames(block, offset, frames, nullptr);
+    }
+
+    /*!
+    \brief Reads the next frames of a subset of the channels of audio data into a block
+
+    Behaves like read(multisignal<T>&), except channel c of the block receives channel channels[c]
+    of the file.
+
+    \param[out] block Multi-channel signal with one channel per selected channel
+    \param[in] channels Indices of the channels to read, in the order they are stored in the block
+    \return Number of frames read (zero once the end of the file is reached)
+    */
+    size_t read(multisignal<T>& block, const std::vector<size_t>& channels)
+    {
+        return this->read(block, 0, block.size(), channels);
+    }
+
+    /*!
+    \brief Reads the next frames of a subset of the channels of audio data into part of a block
+    \param[out] block Multi-channel signal with one channel per selected channel
+    \param[in] offset Frame of the block to store the first frame read in
+    \param[in] frames Maximum number of frames to read (clamped to the end of the block)
+    \param[in] channels Indices of the channels to read, in the order they are stored in the block
+    \return Number of frames read (zero once the end of the file is reached)
+    */
+    size_t read(multisignal<T>&            block,
+                size_t                     offset,
+                size_t                     frames,
+                const std::vector<size_t>& channels)
+    {
+        if (block.channels() != channels.size())
+        {
+            throw std::invalid_argument("Block channel count does not match channel selection for "
+                                        "wave_file '"
+                                        + m_path.string() + "'");
+        }
+
+        for (const auto channel : channels)
+        {
+            if (channel >= m_layout.channels)
+            {
+                throw std::out_of_range("Invalid channel for wave_file '" + m_path.string() + "'");
+            }
+        }
+
+        return this->read_frames(block, offset, frames, &channels);
+    }
+
+private:
+    // Reads the next frames into the block, either every channel or only the selected ones
+    size_t read_frames(multisignal<T>&            block,
+                       size_t                     offset,
+                       size_t                     frames,
+                       const std::vector<size_t>* selection)
+    {
+        // Select the codec once so the whole read runs with the conversion resolved at compile time
+        return visit_sample_codec<T>(m_layout.subformat, [&](auto codec) {
+            return this->read_frames(codec, block, offset, frames, selection);
+        });
+    }
+
+    template <typename Codec>
+    size_t read_frames(Codec,
+                       multisignal<T>&            block,
+                       size_t                     offset,
+                       size_t                     frames,
+                       const std::vector<size_t>* selection)
+    {
+        offset = std::min(offset, block.size());
+        frames = std::min({frames, block.size() - offset, m_layout.size - m_position});
+
+        const auto block_align  = m_layout.channels * Codec::sample_size;
+        const auto block_frames = detail::block_frames(block_align);
+
+        // Buffers only ever grow, so reusing a reader doesn't allocate after the first block
+        const auto buffer_frames = std::min(block_frames, frames);
+        if (m_samples.size() < buffer_frames * m_layout.channels)
+        {
+            m_samples.resize(buffer_frames * m_layout.channels);
+        }
+
+        for (size_t frame = 0; frame < frames; frame += block_frames)
+        {
+            const auto count    = std::min(block_frames, frames - frame);
+            const auto position = m_layout.data_position + (m_position + frame) * block_align;
+
+            const std::byte* data{};
+            if (m_mapping)
+            {
+                // Pages of the mapping are read by the system as they are decoded
+                detail::count_read(m_stats.get(), count * block_align, 0);
+                data = m_mapping->data() + position;
+            }
+            else
+            {
+                if (m_buffer.size() < buffer_frames * block_align)
+                {
+                    m_buffer.resize(buffer_frames * block_align);
+                }
+
+                bool success{};
+                {
+                    const detail::scoped_trace trace("read");
+                    const detail::scoped_time  time(m_stats.get(),
+                                                    &detail::stats_counters::io_time);
+                    success = m_handle->read_at(position, m_buffer.data(), count * block_align);
+                }
+
+                if (!success)
+                {
+                    throw std::runtime_error("Unexpected EOF for wave_file '" + m_path.string()
+                                             + "'");
+                }
+
+                detail::count_read(m_stats.get(), count * block_align);
+                data = m_buffer.data();
+            }
+
+            const detail::scoped_trace trace("decode");
+            const detail::scoped_time  time(m_stats.get(), &detail::stats_counters::decode_time);
+
+            if (selection && selection->size() * lane_ratio <= m_layout.channels)
+            {
+                // Only a few channels are wanted, so decode just their lanes of each frame
+                for (size_t c = 0; c < selection->size(); ++c)
+                {
+                    Codec::decode_strided(data + (*selection)[c] * Codec::sample_size,
+                                          block_align,
+                                          m_samples.data() + c * count,
+                                          count);
+                }
+
+                detail::deplanarize(m_samples.data(), count, offset + frame, block);
+            }
+            else if (selection)
+            {
+                Codec::decode(data, m_samples.data(), count * m_layout.channels);
+                detail::deinterleave(m_samples.data(),
+                                     count,
+                                     m_layout.channels,
+                                     *selection,
+                                     offset + frame,
+                                     block);
+            }
+            else
+            {
+                Codec::decode(data, m_samples.data(), count * m_layout.channels);
+                detail::deinterleave(m_samples.data(), count, offset + frame, block);
+            }
+        }
+
+        m_position += frames;
+        return frames;
+    }
+
+    // Selecting at most one in this many channels decodes the selected lanes one sample at a time
+    // instead of decoding whole frames with the vectorized kernels and discarding the rest
+    static constexpr size_t lane_ratio = 4;
+
+    size_t block_align() const
+    {
+        return m_layout.channels * detail::sample_size(m_layout.subformat);
+    }
+
+    std::filesystem::path                      m_path;
+    detail::wave_layout                        m_layout;
+    size_t                                     m_position;
+    std::shared_ptr<const detail::file_handle> m_handle;
+    std::shared_ptr<const detail::mapped_file> m_mapping;
+    std::shared_ptr<detail::stats_counters>    m_stats;
+    std::vector<std::byte>                     m_buffer;
+    std::vector<T>                             m_samples;
+};
+
+}  // namespace tnt::audio
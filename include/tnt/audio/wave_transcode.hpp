@@ -0,0 +1,186 @@
+#pragma once
+
+#include "detail/file_handle.hpp"
+#include "detail/wave.hpp"
+#include "detail/wave_header.hpp"
+#include "sample_codec.hpp"
+#include "trace.hpp"
+#include "wave_format.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+namespace tnt::audio
+{
+
+namespace detail
+{
+
+// Every sample of these subformats is exactly representable as a float, so converting between two
+// of them through float gives the same result as through double with half the memory traffic
+inline bool fits_float(const wave_subformat& subformat)
+{
+    return subformat != wave_subformat::pcm_int32 && subformat != wave_subformat::ieee_float64;
+}
+
+// Converts the sample data a block of frames at a time, staging each block as samples of type T
+template <typename T, typename Source, typename Target>
+void transcode_frames(Source,
+                      Target,
+                      const std::filesystem::path& path,
+                      const file_handle&           handle,
+                      const wave_layout&           layout,
+                      std::ofstream&               file)
+{
+    const auto source_align = layout.channels * Source::sample_size;
+    const auto target_align = layout.channels * Target::sample_size;
+    const auto block_frames = detail::block_frames(std::max(source_align, target_align));
+
+    const auto buffer_frames = std::min(block_frames, layout.size);
+
+    std::vector<std::byte> source(buffer_frames * source_align);
+    std::vector<std::byte> target(buffer_frames * target_align);
+    std::vector<T>         samples(buffer_frames * layout.channels);
+
+    for (size_t frame = 0; frame < layout.size; frame += block_frames)
+    {
+        const auto count    = std::min(block_frames, layout.size - frame);
+        const auto position = layout.data_position + frame * source_align;
+
+        bool success{};
+        {
+            const scoped_trace trace("read");
+            success = handle.read_at(position, source.data(), count * source_align);
+        }
+
+        if (!success)
+        {
+            throw std::runtime_error("Unexpected EOF for wave_file '" + path.string() + "'");
+        }
+
+        // Samples stay interleaved, the conversion doesn't care which channel they belong to
+        if constexpr (std::is_same_v<Source, Target>)
+        {
+            const scoped_trace trace("write");
+            file.write(reinterpret_cast<const char*>(source.data()),
+                       static_cast<std::streamsize>(count * source_align));
+        }
+        else
+        {
+            {
+                const scoped_trace trace("decode");
+                Source::decode(source.data(), samples.data(), count * layout.channels);
+            }
+
+            {
+                const scoped_trace trace("encode");
+                Target::encode(samples.data(), target.data(), count * layout.channels);
+            }
+
+            const scoped_trace trace("write");
+            file.write(reinterpret_cast<const char*>(target.data()),
+                       static_cast<std::streamsize>(count * target_align));
+        }
+    }
+}
+
+template <typename T>
+void transcode_frames(const std::filesystem::path& path,
+                      const file_handle&           handle,
+                      const wave_layout&           layout,
+                      const wave_subformat&        subformat,
+                      std::ofstream&               file)
+{
+    // Select both codecs once so the whole conversion runs with them resolved at compile time
+    visit_sample_codec<T>(layout.subformat, [&](auto source) {
+        visit_sample_codec<T>(subformat, [&](auto target) {
+            transcode_frames<T>(source, target, path, handle, layout, file);
+        });
+    });
+}
+
+}  // namespace detail
+
+/*!
+\brief Converts a wave file to another subformat without decoding the whole file at once
+
+The sample data is read, converted and written one block of frames at a time, so memory use stays
+constant no matter how long the file is. Samples are converted exactly as reading the file into a
+multisignal<double> and writing it back would convert them, and are copied unchanged if the
+subformat doesn't change.
+
+\param[in] input Path to the wave file to convert
+\param[in] output Path to write the converted wave file to (must differ from the input)
+\param[in] format Format to write the wave file in
+\param[in] subformat Subformat indicating the data type to store the data in
+\return Number of frames converted
+*/
+inline size_t transcode_wave_file(const std::filesystem::path& input,
+                                  const std::filesystem::path& output,
+                                  const wave_format&           format,
+                                  const wave_subformat&        subformat)
+{
+    std::error_code error{};
+    if (std::filesystem::equivalent(input, output, error))
+    {
+        throw std::invalid_argument("Can't transcode wave_file '" + input.string()
+                                    + "' onto itself");
+    }
+
+    const detail::file_handle handle(input);
+    if (!handle.is_open())
+    {
+        throw std::runtime_error("Failed to open wave_file '" + input.string() + "' for reading");
+    }
+
+    const auto read = [&handle](size_t offset, std::byte* data, size_t size) {
+        return handle.read_at(offset, data, size);
+    };
+
+    const auto layout = detail::parse_header(input, read);
+
+    // The size of the data is known up front, so the header is written once with its final sizes
+    const auto header = detail::make_header(output,
+                                            format,
+                                            subformat,
+                                            layout.sample_rate,
+                                            layout.channels,
+                                            layout.size * layout.channels
+                                                * detail::sample_size(subformat));
+
+    std::ofstream file(output, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Failed to open wave_file '" + output.string()
+                                 + "' for writing");
+    }
+
+    file.write(reinterpret_cast<const char*>(header.bytes.data()),
+               static_cast<std::streamsize>(header.bytes.size()));
+
+    if (detail::fits_float(layout.subformat) && detail::fits_float(subformat))
+    {
+        detail::transcode_frames<float>(input, handle, layout, subformat, file);
+    }
+    else
+    {
+        detail::transcode_frames<double>(input, handle, layout, subformat, file);
+    }
+
+    file.close();
+    if (file.fail())
+    {
+        throw std::runtime_error("Failed to write wave_file '" + output.string() + "'");
+    }
+
+    return layout.size;
+}
+
+}  // namespace tnt::audio
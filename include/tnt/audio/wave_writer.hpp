@@ -0,0 +1,254 @@
+#pragma once
+
+#include "detail/wave.hpp"
+#include "detail/wave_header.hpp"
+#include "file_stats.hpp"
+#include "multisignal.hpp"
+#include "sample_codec.hpp"
+#include "trace.hpp"
+#include "wave_format.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace tnt::audio
+{
+
+/*!
+\brief Writes the audio data of a wave file a block of frames at a time
+
+A header with placeholder sizes is written when the writer is opened and blocks of frames are
+appended as they arrive. The sizes in the header are filled in by finalize() (or on destruction), so
+memory use stays constant no matter how long the recording is. Writers are created with
+wave_file::open_writer().
+*/
+template <typename T>
+class wave_writer final
+{
+public:
+    /*!
+    \brief Constructor
+    \param[in] path Path to the wave file on the system
+    \param[in] sample_rate Sample rate of the audio data
+    \param[in] channels Number of channels of audio data
+    \param[in] format Format to write the wave file in
+    \param[in] subformat Subformat indicating the data type to store the data in
+    \param[in] stats Counters to record the work done in (null to not record it)
+    */
+    wave_writer(const std::filesystem::path&            path,
+                size_t                                  sample_rate,
+                size_t                                  channels,
+                const wave_format&                      format,
+                const wave_subformat&                   subformat,
+                std::shared_ptr<detail::stats_counters> stats = nullptr)
+        : m_path(path)
+        , m_sample_rate(sample_rate)
+        , m_channels(channels)
+        , m_subformat(subformat)
+        , m_header(detail::make_header(path, format, subformat, sample_rate, channels, 0))
+        , m_size()
+        , m_stats(std::move(stats))
+        , m_file()
+        , m_buffer()
+        , m_samples()
+    {
+        m_file.open(m_path, std::ios::binary | std::ios::trunc);
+        if (!m_file.is_open())
+        {
+            throw std::runtime_error("Failed to open wave_file '" + m_path.string()
+                                     + "' for writing");
+        }
+
+        this->write_bytes(m_header.bytes.data(), m_header.bytes.size());
+    }
+
+    wave_writer(wave_writer&&) = default;
+
+    wave_writer& operator=(wave_writer&&) = delete;
+
+    /*!
+    \brief Destructor (finalizes the file if it hasn't been already)
+    */
+    ~wave_writer()
+    {
+        try
+        {
+            this->finalize();
+        }
+        catch (...)
+        {
+            // Destructors must not throw, call finalize() explicitly to handle errors
+        }
+    }
+
+    /*!
+    \brief Gets the sample rate of the audio data
+    \return Sample Rate
+    */
+    size_t sample_rate() const
+    {
+        return m_sample_rate;
+    }
+
+    /*!
+    \brief Gets the number of frames written so far
+    \return Size
+    */
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    /*!
+    \brief Gets the number of channels of audio data
+    \return Channels
+    */
+    size_t channels() const
+    {
+        return m_channels;
+    }
+
+    /*!
+    \brief Gets the location and shape of the audio data written so far
+    \return Layout
+    */
+    detail::wave_layout layout() const
+    {
+        return {m_subformat, m_sample_rate, m_channels, m_size, m_header.bytes.size(), 0};
+    }
+
+    /*!
+    \brief Appends all frames of a block to the file
+    \param[in] block Multi-channel signal with the same number of channels as the file
+    */
+    void write(const multisignal<T>& block)
+    {
+        this->write(block, block.size());
+    }
+
+    /*!
+    \brief Appends the first frames of a block to the file
+    \param[in] block Multi-channel signal with the same number of channels as the file
+    \param[in] frames Number of frames of the block to write
+    */
+    void write(const multisignal<T>& block, size_t frames)
+    {
+        if (!m_file.is_open())
+        {
+            throw std::runtime_error("wave_file '" + m_path.string() + "' is already finalized");
+        }
+
+        if (block.channels() != m_channels)
+        {
+            throw std::invalid_argument("Block channel count does not match wave_file '"
+                                        + m_path.string() + "'");
+        }
+
+        frames = std::min(frames, block.size());
+
+        // Select the codec once so the whole write runs with the conversion resolved at compile
+        // time
+        visit_sample_codec<T>(m_subformat, [&](auto codec) {
+            this->write_frames(codec, block, frames);
+        });
+
+        if (m_file.fail())
+        {
+            throw std::runtime_error("Failed to write wave_file '" + m_path.string() + "'");
+        }
+
+        m_size += frames;
+    }
+
+    /*!
+    \brief Fills in the sizes in the header and closes the file
+
+    Does nothing if the file is already finalized.
+    */
+    void finalize()
+    {
+        if (!m_file.is_open())
+        {
+            return;
+        }
+
+        const detail::scoped_trace trace("flush");
+
+        // The header switches to RF64 if the data outgrew 32 bit sizes, so rewrite all of it
+        detail::set_data_size(m_header, static_cast<uint64_t>(m_size) * m_header.block_align);
+
+        m_file.seekp(0);
+        this->write_bytes(m_header.bytes.data(), m_header.bytes.size());
+
+        {
+            const detail::scoped_time time(m_stats.get(), &detail::stats_counters::io_time);
+            m_file.close();
+        }
+
+        if (m_file.fail())
+        {
+            throw std::runtime_error("Failed to write wave_file '" + m_path.string() + "'");
+        }
+    }
+
+private:
+    // Encodes and appends the first frames of a block
+    template <typename Codec>
+    void write_frames(Codec, const multisignal<T>& block, size_t frames)
+    {
+        // Encode whole frames in large blocks so the stream is only touched once per block
+        const auto block_align  = m_header.block_align;
+        const auto block_frames = detail::block_frames(block_align);
+
+        // Buffers only ever grow, so reusing a writer doesn't allocate after the first block
+        const auto buffer_frames = std::min(block_frames, frames);
+        if (m_samples.size() < buffer_frames * m_channels)
+        {
+            m_samples.resize(buffer_frames * m_channels);
+            m_buffer.resize(buffer_frames * block_align);
+        }
+
+        for (size_t offset = 0; offset < frames; offset += block_frames)
+        {
+            const auto count = std::min(block_frames, frames - offset);
+
+            {
+                const detail::scoped_trace trace("encode");
+                const detail::scoped_time  time(m_stats.get(),
+                                                &detail::stats_counters::encode_time);
+                detail::interleave(block, offset, count, m_samples.data());
+                Codec::encode(m_samples.data(), m_buffer.data(), count * m_channels);
+            }
+
+            this->write_bytes(m_buffer.data(), count * block_align);
+        }
+    }
+
+    void write_bytes(const std::byte* data, size_t size)
+    {
+        const detail::scoped_trace trace("write");
+        const detail::scoped_time  time(m_stats.get(), &detail::stats_counters::io_time);
+        m_file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+        detail::count_write(m_stats.get(), size);
+    }
+
+    std::filesystem::path                   m_path;
+    size_t                                  m_sample_rate;
+    size_t                                  m_channels;
+    wave_subformat                          m_subformat;
+    detail::wave_header                     m_header;
+    size_t                                  m_size;
+    std::shared_ptr<detail::stats_counters> m_stats;
+    std::ofstream                           m_file;
+    std::vector<std::byte>                  m_buffer;
+    std::vector<T>                          m_samples;
+};
+
+}  // namespace tnt::audio
@@ -0,0 +1,112 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <cstddef>
+#include <random>
+#include <tnt/audio/detail/decode.hpp>
+#include <vector>
+
+using namespace tnt;
+
+namespace
+{
+
+std::vector<std::byte> random_bytes(size_t size)
+{
+    std::mt19937                       generator(size);
+    std::uniform_int_distribution<int> distribution(0, 255);
+
+    std::vector<std::byte> bytes(size);
+    for (auto& byte : bytes)
+    {
+        byte = static_cast<std::byte>(distribution(generator));
+    }
+
+    return bytes;
+}
+
+std::vector<audio::detail::simd_level> supported_levels()
+{
+    std::vector<audio::detail::simd_level> levels{audio::detail::simd_level::scalar};
+    for (auto level = audio::detail::simd_level::sse2;
+         level <= audio::detail::cpu_simd_level();
+         level = static_cast<audio::detail::simd_level>(static_cast<int>(level) + 1))
+    {
+        levels.push_back(level);
+    }
+
+    return levels;
+}
+
+// Every level must produce exactly the same samples as the scalar kernel
+template <typename T, typename Kernel>
+void check_kernel(size_t sample_size, Kernel kernel)
+{
+    // Odd counts exercise the scalar tails of the vectorized kernels
+    for (const size_t count : {0, 1, 7, 15, 16, 17, 33, 1001})
+    {
+        const auto data = random_bytes(count * sample_size);
+
+        std::vector<T> expected(count);
+        kernel(data.data(), expected.data(), count, audio::detail::simd_level::scalar);
+
+        for (const auto level : supported_levels())
+        {
+            std::vector<T> samples(count);
+            kernel(data.data(), samples.data(), count, level);
+
+            CHECK(samples == expected);
+        }
+    }
+}
+
+}  // namespace
+
+TEMPLATE_TEST_CASE("decode", "[decode]", float, double)
+{
+    SECTION("pcm_uint8")
+    {
+        check_kernel<TestType>(1, [](auto... args) {
+            audio::detail::decode_pcm_uint8(args...);
+        });
+
+        const std::vector<std::byte> data{std::byte{0x00}, std::byte{0x80}, std::byte{0xFF}};
+        std::vector<TestType>        samples(data.size());
+        audio::detail::decode_pcm_uint8(data.data(), samples.data(), samples.size());
+
+        CHECK(samples[0] == -1);
+        CHECK(samples[1] == 0);
+        CHECK(samples[2] == static_cast<TestType>(127) / 128);
+    }
+
+    SECTION("pcm_int16")
+    {
+        check_kernel<TestType>(2, [](auto... args) {
+            audio::detail::decode_pcm_int16(args...);
+        });
+    }
+
+    SECTION("pcm_int24")
+    {
+        check_kernel<TestType>(3, [](auto... args) {
+            audio::detail::decode_pcm_int24(args...);
+        });
+
+        const std::vector<std::byte> data{std::byte{0x00},
+                                          std::byte{0x00},
+                                          std::byte{0x80},
+                                          std::byte{0xFF},
+                                          std::byte{0xFF},
+                                          std::byte{0x7F}};
+        std::vector<TestType>        samples(2);
+        audio::detail::decode_pcm_int24(data.data(), samples.data(), samples.size());
+
+        CHECK(samples[0] == -1);
+        CHECK(samples[1] == static_cast<TestType>(0x7FFFFF) / 0x800000);
+    }
+
+    SECTION("pcm_int32")
+    {
+        check_kernel<TestType>(4, [](auto... args) {
+            audio::detail::decode_pcm_int32(args...);
+        });
+    }
+}
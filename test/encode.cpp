@@ -0,0 +1,209 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <tnt/audio/detail/decode.hpp>
+#include <tnt/audio/detail/encode.hpp>
+#include <vector>
+
+using namespace tnt;
+
+namespace
+{
+
+// Includes values outside of [-1, 1] and NaN to exercise clamping
+template <typename T>
+std::vector<T> random_samples(size_t size)
+{
+    std::mt19937                      generator(size);
+    std::uniform_real_distribution<T> distribution(-1.25, 1.25);
+
+    std::vector<T> samples(size);
+    for (auto& sample : samples)
+    {
+        sample = distribution(generator);
+    }
+
+    if (size > 3)
+    {
+        samples[0] = 1;
+        samples[1] = -1;
+        samples[2] = std::numeric_limits<T>::quiet_NaN();
+    }
+
+    return samples;
+}
+
+std::vector<audio::detail::simd_level> supported_levels()
+{
+    std::vector<audio::detail::simd_level> levels{audio::detail::simd_level::scalar};
+    for (auto level = audio::detail::simd_level::sse2;
+         level <= audio::detail::cpu_simd_level();
+         level = static_cast<audio::detail::simd_level>(static_cast<int>(level) + 1))
+    {
+        levels.push_back(level);
+    }
+
+    return levels;
+}
+
+// Every level must produce exactly the same bytes as the scalar kernel
+template <typename T, typename Kernel>
+void check_kernel(size_t sample_size, Kernel kernel)
+{
+    // Odd counts exercise the scalar tails of the vectorized kernels
+    for (const size_t count : {0, 1, 7, 15, 16, 17, 33, 1001})
+    {
+        const auto samples = random_samples<T>(count);
+
+        std::vector<std::byte> expected(count * sample_size);
+        kernel(samples.data(), expected.data(), count, audio::detail::simd_level::scalar);
+
+        for (const auto level : supported_levels())
+        {
+            std::vector<std::byte> data(count * sample_size);
+            kernel(samples.data(), data.data(), count, level);
+
+            CHECK(data == expected);
+        }
+    }
+}
+
+// Encoding then decoding must be accurate to within half of the quantization step
+template <typename T, typename Encode, typename Decode>
+void check_round_trip(size_t sample_size, T step, Encode encode, Decode decode)
+{
+    std::vector<T> samples(1001);
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        samples[i] = static_cast<T>(std::sin(i * 0.01) * 0.99);
+    }
+
+    std::vector<std::byte> data(samples.size() * sample_size);
+    encode(samples.data(), data.data(), samples.size());
+
+    std::vector<T> decoded(samples.size());
+    decode(data.data(), decoded.data(), decoded.size());
+
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        CHECK(std::abs(decoded[i] - samples[i]) <= step / 2);
+    }
+}
+
+}  // namespace
+
+TEMPLATE_TEST_CASE("encode", "[encode]", float, double)
+{
+    SECTION("pcm_uint8")
+    {
+        check_kernel<TestType>(1, [](auto... args) {
+            audio::detail::encode_pcm_uint8(args...);
+        });
+
+        check_round_trip<TestType>(
+            1,
+            static_cast<TestType>(1) / 0x80,
+            [](auto... args) { audio::detail::encode_pcm_uint8(args...); },
+            [](auto... args) { audio::detail::decode_pcm_uint8(args...); });
+
+        const std::vector<TestType> samples{-2, -1, 0, 1, 2};
+        std::vector<std::byte>      data(samples.size());
+        audio::detail::encode_pcm_uint8(samples.data(), data.data(), samples.size());
+
+        CHECK(data
+              == std::vector<std::byte>{std::byte{0x00},
+                                        std::byte{0x00},
+                                        std::byte{0x80},
+                                        std::byte{0xFF},
+                                        std::byte{0xFF}});
+    }
+
+    SECTION("pcm_int16")
+    {
+        check_kernel<TestType>(2, [](auto... args) {
+            audio::detail::encode_pcm_int16(args...);
+        });
+
+        check_round_trip<TestType>(
+            2,
+            static_cast<TestType>(1) / 0x8000,
+            [](auto... args) { audio::detail::encode_pcm_int16(args...); },
+            [](auto... args) { audio::detail::decode_pcm_int16(args...); });
+    }
+
+    SECTION("pcm_int24")
+    {
+        check_kernel<TestType>(3, [](auto... args) {
+            audio::detail::encode_pcm_int24(args...);
+        });
+
+        check_round_trip<TestType>(
+            3,
+            static_cast<TestType>(1) / 0x800000,
+            [](auto... args) { audio::detail::encode_pcm_int24(args...); },
+            [](auto... args) { audio::detail::decode_pcm_int24(args...); });
+
+        const std::vector<TestType> samples{-1, 1};
+        std::vector<std::byte>      data(samples.size() * 3);
+        audio::detail::encode_pcm_int24(samples.data(), data.data(), samples.size());
+
+        CHECK(data
+              == std::vector<std::byte>{std::byte{0x00},
+                                        std::byte{0x00},
+                                        std::byte{0x80},
+                                        std::byte{0xFF},
+                                        std::byte{0xFF},
+                                        std::byte{0x7F}});
+    }
+
+    SECTION("pcm_int32")
+    {
+        check_kernel<TestType>(4, [](auto... args) {
+            audio::detail::encode_pcm_int32(args...);
+        });
+
+        const std::vector<TestType> samples{-1, 1};
+        std::vector<int32_t>        data(samples.size());
+        audio::detail::encode_pcm_int32(samples.data(),
+                                        reinterpret_cast<std::byte*>(data.data()),
+                                        samples.size());
+
+        CHECK(data[0] == std::numeric_limits<int32_t>::min());
+        CHECK(data[1] == std::numeric_limits<int32_t>::max());
+    }
+
+    SECTION("ieee_float32")
+    {
+        check_kernel<TestType>(4, [](auto... args) {
+            audio::detail::encode_ieee_float32(args...);
+        });
+
+        check_round_trip<TestType>(
+            4,
+            std::numeric_limits<float>::epsilon(),
+            [](auto... args) { audio::detail::encode_ieee_float32(args...); },
+            [](auto... args) { audio::detail::decode_ieee_float32(args...); });
+
+        // The data of empty vectors may be null
+        std::vector<TestType> samples;
+        audio::detail::decode_ieee_float32(nullptr, samples.data(), 0);
+        CHECK(samples.empty());
+    }
+
+    SECTION("ieee_float64")
+    {
+        check_round_trip<TestType>(
+            8,
+            0,
+            [](auto... args) { audio::detail::encode_ieee_float64(args...); },
+            [](auto... args) { audio::detail::decode_ieee_float64(args...); });
+
+        std::vector<TestType>  samples;
+        std::vector<std::byte> data;
+        audio::detail::encode_ieee_float64(samples.data(), data.data(), 0);
+        audio::detail::decode_ieee_float64(data.data(), samples.data(), 0);
+        CHECK(data.empty());
+    }
+}
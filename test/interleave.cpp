@@ -0,0 +1,78 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <cstddef>
+#include <tnt/audio/detail/interleave.hpp>
+#include <tnt/audio/multisignal.hpp>
+#include <vector>
+
+using namespace tnt;
+
+namespace
+{
+
+// Every sample gets a distinct value that encodes its frame and channel
+template <typename T>
+std::vector<T> interleaved(size_t frames, size_t channels)
+{
+    std::vector<T> samples(frames * channels);
+    for (size_t n = 0; n < frames; ++n)
+    {
+        for (size_t c = 0; c < channels; ++c)
+        {
+            samples[n * channels + c] = static_cast<T>(n * 1000 + c);
+        }
+    }
+
+    return samples;
+}
+
+}  // namespace
+
+TEMPLATE_TEST_CASE("interleave", "[interleave]", float, double)
+{
+    // Covers each of the specialized channel counts and the blocked path, with frame counts that
+    // don't fill the last tile
+    for (const size_t channels : {1, 2, 3, 6, 8, 17, 70})
+    {
+        constexpr size_t frames  = 150;
+        const auto       samples = interleaved<TestType>(frames, channels);
+
+        SECTION("deinterleave")
+        {
+            audio::multisignal<TestType> signal(44100, frames + 1, channels);
+            audio::detail::deinterleave(samples.data(), frames, 1, signal);
+
+            for (size_t n = 0; n < frames; ++n)
+            {
+                for (size_t c = 0; c < channels; ++c)
+                {
+                    CHECK(signal[n + 1][c] == samples[n * channels + c]);
+                }
+            }
+        }
+
+        SECTION("deinterleave selection")
+        {
+            const std::vector<size_t> selection{channels - 1, 0};
+
+            audio::multisignal<TestType> signal(44100, frames, selection.size());
+            audio::detail::deinterleave(samples.data(), frames, channels, selection, 0, signal);
+
+            for (size_t n = 0; n < frames; ++n)
+            {
+                CHECK(signal[n][0] == samples[n * channels + channels - 1]);
+                CHECK(signal[n][1] == samples[n * channels]);
+            }
+        }
+
+        SECTION("interleave")
+        {
+            audio::multisignal<TestType> signal(44100, frames + 1, channels);
+            audio::detail::deinterleave(samples.data(), frames, 1, signal);
+
+            std::vector<TestType> result(frames * channels);
+            audio::detail::interleave(signal, 1, frames, result.data());
+
+            CHECK(result == samples);
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <tnt/audio/sample_codec.hpp>
+#include <vector>
+
+using namespace tnt;
+
+namespace
+{
+
+// Encoding then decoding must be accurate to within half of the quantization step
+template <typename T, audio::wave_subformat Subformat>
+void check_round_trip()
+{
+    using Codec = audio::sample_codec<Subformat, T>;
+
+    std::vector<T> samples(1001);
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        samples[i] = static_cast<T>(std::sin(i * 0.01) * 0.99);
+    }
+
+    std::vector<std::byte> data(samples.size() * Codec::sample_size);
+    Codec::encode(samples.data(), data.data(), samples.size());
+
+    std::vector<T> decoded(samples.size());
+    Codec::decode(data.data(), decoded.data(), decoded.size());
+
+    const auto step = static_cast<T>(1 / Codec::full_scale);
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        CHECK(std::abs(decoded[i] - samples[i]) <= step / 2);
+    }
+}
+
+}  // namespace
+
+TEMPLATE_TEST_CASE("sample_codec", "[sample_codec]", float, double)
+{
+    SECTION("Round trip")
+    {
+        check_round_trip<TestType, audio::wave_subformat::pcm_uint8>();
+        check_round_trip<TestType, audio::wave_subformat::pcm_int16>();
+        check_round_trip<TestType, audio::wave_subformat::pcm_int24>();
+        check_round_trip<TestType, audio::wave_subformat::pcm_int32>();
+        check_round_trip<TestType, audio::wave_subformat::ieee_float32>();
+        check_round_trip<TestType, audio::wave_subformat::ieee_float64>();
+    }
+
+    SECTION("Visit")
+    {
+        const auto sample_size = [](auto codec) { return decltype(codec)::sample_size; };
+
+        CHECK(audio::visit_sample_codec<TestType>(audio::wave_subformat::pcm_uint8, sample_size)
+              == 1);
+        CHECK(audio::visit_sample_codec<TestType>(audio::wave_subformat::pcm_int24, sample_size)
+              == 3);
+        CHECK(audio::visit_sample_codec<TestType>(audio::wave_subformat::ieee_float64, sample_size)
+              == 8);
+
+        const auto invalid = static_cast<audio::wave_subformat>(-1);
+        CHECK_THROWS_AS(audio::visit_sample_codec<TestType>(invalid, sample_size),
+                        std::invalid_argument);
+    }
+}
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <regex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tnt/audio/multisignal.hpp>
+#include <tnt/audio/trace.hpp>
+#include <tnt/audio/wave_file.hpp>
+
+using namespace tnt;
+
+namespace
+{
+
+std::string read_text(const std::filesystem::path& path)
+{
+    std::ifstream stream(path);
+    return {std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+}
+
+bool has_event(const std::string& trace, const std::string& name)
+{
+    return trace.find(R"({"name": ")" + name + R"(", "cat": "audio", "ph": "X")")
+           != std::string::npos;
+}
+
+}  // namespace
+
+TEST_CASE("trace", "[trace]")
+{
+    const std::string file  = "data/wave_files/tmp-trace.wav";
+    const std::string trace = "data/wave_files/tmp-trace.json";
+
+    audio::multisignal<float> signal(44100, 50000, 2);
+    for (size_t n = 0; n < signal.size(); ++n)
+    {
+        signal[n][0] = static_cast<float>(n % 100) / 100;
+        signal[n][1] = -signal[n][0];
+    }
+
+    // Nothing is recorded until tracing starts
+    audio::wave_file<float>(file).write(signal,
+                                        audio::wave_format::pcm,
+                                        audio::wave_subformat::pcm_int16);
+
+    std::filesystem::remove(trace);
+    audio::stop_trace();
+    CHECK(!std::filesystem::exists(trace));
+
+    audio::start_trace(trace);
+
+    audio::wave_file<float>(file).write(signal,
+                                        audio::wave_format::pcm,
+                                        audio::wave_subformat::pcm_int16);
+
+    audio::wave_file<float> stream(file);
+    CHECK(stream.read().size() == signal.size());
+
+    // Files read on other threads are recorded with their own thread IDs
+    size_t      frames{};
+    std::thread thread([&] { frames = audio::wave_file<float>(file).read().size(); });
+    thread.join();
+    CHECK(frames == signal.size());
+
+    // Timestamps keep sub-microsecond precision however long the trace runs
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    CHECK(audio::wave_file<float>(file).size() == signal.size());
+
+    audio::stop_trace();
+
+    // Events after tracing stops are dropped
+    CHECK(audio::wave_file<float>(file).read().size() == signal.size());
+
+    const auto text = read_text(trace);
+    REQUIRE(!text.empty());
+    CHECK(text.front() == '[');
+    CHECK(text.find_last_not_of('\n') == text.rfind(']'));
+
+    for (const auto& name :
+         {"open", "parse_header", "walk_chunks", "read", "decode", "encode", "write", "flush"})
+    {
+        CHECK(has_event(text, name));
+    }
+
+    CHECK(text.find(R"("args": {"path": "data/wave_files/tmp-trace.wav"})") != std::string::npos);
+
+    std::set<std::string> threads;
+    const std::regex      thread_id(R"("tid": (\d+))");
+    for (std::sregex_iterator i(text.begin(), text.end(), thread_id), end; i != end; ++i)
+    {
+        threads.insert((*i)[1]);
+    }
+
+    CHECK(threads.size() == 2);
+
+    CHECK(text.find("e+") == std::string::npos);
+
+    double           last_timestamp{};
+    const std::regex timestamp(R"("ts": (\d+\.\d{3}), "dur": \d+\.\d{3})");
+    for (std::sregex_iterator i(text.begin(), text.end(), timestamp), end; i != end; ++i)
+    {
+        last_timestamp = std::max(last_timestamp, std::stod((*i)[1]));
+    }
+
+    CHECK(last_timestamp > 1e6);
+
+    CHECK_THROWS_AS(audio::start_trace("data/missing/tmp-trace.json"), std::runtime_error);
+
+    std::filesystem::remove(file);
+    std::filesystem::remove(trace);
+}
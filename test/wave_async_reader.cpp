@@ -0,0 +1,61 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <cstddef>
+#include <string>
+#include <tnt/audio/multisignal.hpp>
+#include <tnt/audio/wave_async_reader.hpp>
+#include <tnt/audio/wave_file.hpp>
+
+using namespace tnt;
+
+TEMPLATE_TEST_CASE("wave_async_reader::read", "[wave_async_reader][read]", float, double)
+{
+    for (const auto* name :
+         {"pcm_uint8", "pcm_int16", "pcm_int24", "pcm_int32", "ieee_float32", "ieee_float64"})
+    {
+        DYNAMIC_SECTION(name)
+        {
+            audio::wave_file<TestType> w(std::string("data/wave_files/") + name + ".wav");
+
+            const auto expected = w.read();
+
+            // Blocks that don't line up with the read ahead buffers make reads span both buffers
+            auto reader = w.open_async_reader(3);
+            audio::multisignal<TestType> block(reader.sample_rate(), 7, reader.channels());
+
+            CHECK(reader.sample_rate() == w.sample_rate());
+            CHECK(reader.size() == w.size());
+            CHECK(reader.channels() == w.channels());
+
+            size_t position = 0;
+            while (const auto frames = reader.read(block))
+            {
+                REQUIRE(position + frames <= expected.size());
+
+                for (size_t n = 0; n < frames; ++n)
+                {
+                    for (size_t c = 0; c < block.channels(); ++c)
+                    {
+                        CHECK(block[n][c] == expected[position + n][c]);
+                    }
+                }
+
+                position += frames;
+                CHECK(reader.position() == position);
+            }
+
+            CHECK(position == expected.size());
+            CHECK(reader.read(block) == 0);
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("wave_async_reader destruction", "[wave_async_reader]", float, double)
+{
+    // Stopping part way through must not wait for the rest of the file
+    audio::wave_file<TestType> w("data/wave_files/ieee_float64.wav");
+
+    auto reader = w.open_async_reader(1);
+    audio::multisignal<TestType> block(reader.sample_rate(), 2, reader.channels());
+
+    CHECK(reader.read(block) == 2);
+}
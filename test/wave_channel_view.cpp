@@ -0,0 +1,30 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <cstddef>
+#include <memory>
+#include <tnt/audio/wave_channel_view.hpp>
+#include <vector>
+
+using namespace tnt;
+
+TEMPLATE_TEST_CASE("wave_channel_view", "[wave_channel_view]", float, double)
+{
+    // Two interleaved channels
+    const auto storage = std::make_shared<std::vector<TestType>>(
+        std::vector<TestType>{0, 10, 1, 11, 2, 12, 3, 13});
+    const auto* data = reinterpret_cast<const std::byte*>(storage->data());
+
+    const audio::wave_channel_view<TestType> left(storage, data, 4, 2 * sizeof(TestType));
+    const audio::wave_channel_view<TestType> right(storage,
+                                                   data + sizeof(TestType),
+                                                   4,
+                                                   2 * sizeof(TestType));
+
+    CHECK(left.size() == 4);
+    CHECK(left.stride() == 2 * sizeof(TestType));
+
+    for (size_t n = 0; n < 4; ++n)
+    {
+        CHECK(left[n] == static_cast<TestType>(n));
+        CHECK(right[n] == static_cast<TestType>(n + 10));
+    }
+}
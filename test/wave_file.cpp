@@ -1,12 +1,21 @@
 #include "config.hpp"
 
 #include <boost/type_index.hpp>
+#include <algorithm>
 #include <catch2/catch_template_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 #include <catch2/matchers/catch_matchers_string.hpp>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <fstream>
+#include <memory>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include <tnt/audio/wave_file.hpp>
 #include <tnt/dsp/multisignal.hpp>
 #include <tnt/dsp/signal.hpp>
@@ -56,6 +65,19 @@ TEMPLATE_TEST_CASE("wave_file construction", "[file][wave_file][constructor]", f
     {
         REQUIRE_NOTHROW(audio::wave_file<TestType>("data/wave_files/nonexistent.wav"));
     }
+
+    SECTION("file is invalid")
+    {
+        const auto test_type = boost::typeindex::type_id<TestType>().pretty_name();
+        const auto file      = "data/wave_files/invalid-" + test_type + ".wav";
+        std::ofstream(file) << "not a wave file";
+
+        REQUIRE_THROWS_WITH(audio::wave_file<TestType>(file),
+                            Catch::Matchers::Equals("Invalid RIFF header for wave_file '" + file
+                                                    + "'"));
+
+        std::filesystem::remove(file);
+    }
 }
 
 TEMPLATE_TEST_CASE("wave_file accessors", "[file][wave_file][accessors]", float, double)
@@ -401,3 +423,677 @@ TEMPLATE_TEST_CASE("wave_file::write", "[file][wave_file][write]", float, double
         }
     }
 }
+
+TEMPLATE_TEST_CASE("wave_file mapped read", "[file][wave_file][read][mapped]", float, double)
+{
+    for (const auto* name :
+         {"pcm_uint8", "pcm_int16", "pcm_int24", "pcm_int32", "ieee_float32", "ieee_float64"})
+    {
+        DYNAMIC_SECTION(name)
+        {
+            const auto path = std::string("data/wave_files/") + name + ".wav";
+
+            audio::wave_file<TestType> stream(path);
+            audio::wave_file<TestType> mapped(path, audio::wave_read_mode::mapped);
+
+            CHECK(mapped.duration() == stream.duration());
+            CHECK(mapped.sample_rate() == stream.sample_rate());
+            CHECK(mapped.size() == stream.size());
+            CHECK(mapped.channels() == stream.channels());
+
+            const auto expected = stream.read();
+            const auto s        = mapped.read();
+
+            REQUIRE(s.size() == expected.size());
+            REQUIRE(s.channels() == expected.channels());
+
+            for (size_t n = 0; n < s.size(); ++n)
+            {
+                for (size_t c = 0; c < s.channels(); ++c)
+                {
+                    CHECK(s[n][c] == expected[n][c]);
+                }
+            }
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("wave_file::read range", "[file][wave_file][read][range]", float, double)
+{
+    for (const auto mode : {audio::wave_read_mode::stream, audio::wave_read_mode::mapped})
+    {
+        for (const auto* name :
+             {"pcm_uint8", "pcm_int16", "pcm_int24", "pcm_int32", "ieee_float32", "ieee_float64"})
+        {
+            DYNAMIC_SECTION(name << (mode == audio::wave_read_mode::mapped ? " mapped" : ""))
+            {
+                audio::wave_file<TestType> w(std::string("data/wave_files/") + name + ".wav", mode);
+
+                const auto expected = w.read();
+
+                SECTION("all channels")
+                {
+                    const auto s = w.read(5, 9);
+
+                    CHECK(s.sample_rate() == expected.sample_rate());
+                    REQUIRE(s.size() == 9);
+                    REQUIRE(s.channels() == expected.channels());
+
+                    for (size_t n = 0; n < s.size(); ++n)
+                    {
+                        for (size_t c = 0; c < s.channels(); ++c)
+                        {
+                            CHECK(s[n][c] == expected[5 + n][c]);
+                        }
+                    }
+                }
+
+                SECTION("channel subset")
+                {
+                    const auto s = w.read(3, 4, {1, 0, 1});
+
+                    REQUIRE(s.size() == 4);
+                    REQUIRE(s.channels() == 3);
+
+                    for (size_t n = 0; n < s.size(); ++n)
+                    {
+                        CHECK(s[n][0] == expected[3 + n][1]);
+                        CHECK(s[n][1] == expected[3 + n][0]);
+                        CHECK(s[n][2] == expected[3 + n][1]);
+                    }
+                }
+
+                SECTION("clamped to the end of the file")
+                {
+                    CHECK(w.read(expected.size() - 2, 100).size() == 2);
+                    CHECK(w.read(expected.size(), 100).size() == 0);
+                }
+
+                SECTION("invalid")
+                {
+                    CHECK_THROWS_AS(w.read(expected.size() + 1, 1), std::out_of_range);
+                    CHECK_THROWS_AS(w.read(0, 1, {expected.channels()}), std::out_of_range);
+                }
+            }
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("wave_file::read_at", "[file][wave_file][read][read_at]", float, double)
+{
+    constexpr size_t channels = 3;
+    constexpr size_t frames   = 30000;
+
+    audio::multisignal<TestType> signal(48000, frames, channels);
+    for (size_t n = 0; n < frames; ++n)
+    {
+        for (size_t c = 0; c < channels; ++c)
+        {
+            signal[n][c] = static_cast<TestType>(static_cast<int>((n * 7 + c * 1000) % 2000) - 1000)
+                           / 1024;
+        }
+    }
+
+    // Need to use a different file name for each type so tests can run in parallel without conflict
+    const auto test_type = boost::typeindex::type_id<TestType>().pretty_name();
+    const auto file      = "data/wave_files/tmp-read-at-" + test_type + ".wav";
+
+    // The file doesn't exist yet, so const reads must work right after writing it
+    std::filesystem::remove(file);
+    audio::wave_file<TestType> w(file);
+    w.write(signal, audio::wave_format::pcm, audio::wave_subformat::pcm_int24);
+
+    const auto expected = w.read();
+
+    SECTION("matches read")
+    {
+        const auto& shared = static_cast<const audio::wave_file<TestType>&>(w);
+
+        const auto s = shared.read_at(1234, 500);
+        REQUIRE(s.size() == 500);
+        REQUIRE(s.channels() == channels);
+        CHECK(s.sample_rate() == 48000);
+
+        for (size_t n = 0; n < s.size(); ++n)
+        {
+            for (size_t c = 0; c < channels; ++c)
+            {
+                CHECK(s[n][c] == expected[1234 + n][c]);
+            }
+        }
+
+        CHECK(shared.read_at(frames - 2, 100).size() == 2);
+        CHECK(shared.read_at(frames, 100).size() == 0);
+        CHECK_THROWS_AS(shared.read_at(frames + 1, 1), std::out_of_range);
+    }
+
+    SECTION("many threads")
+    {
+        const auto& shared = static_cast<const audio::wave_file<TestType>&>(w);
+
+        // Each thread reads its own interleaving of overlapping segments into a reused signal
+        constexpr size_t         threads = 8;
+        std::vector<size_t>      mismatches(threads);
+        std::vector<std::thread> pool;
+        for (size_t t = 0; t < threads; ++t)
+        {
+            pool.emplace_back([&, t] {
+                audio::multisignal<TestType> segment(48000, 0, channels);
+                for (size_t i = 0; i < 50; ++i)
+                {
+                    const auto start = (t * 3989 + i * 1237) % frames;
+                    const auto count = shared.read_at(segment, start, 1000 + 37 * t);
+
+                    for (size_t n = 0; n < count; ++n)
+                    {
+                        for (size_t c = 0; c < channels; ++c)
+                        {
+                            mismatches[t] += segment[n][c] != expected[start + n][c];
+                        }
+                    }
+                }
+            });
+        }
+
+        for (auto& thread : pool)
+        {
+            thread.join();
+        }
+
+        for (const auto count : mismatches)
+        {
+            CHECK(count == 0);
+        }
+    }
+
+    SECTION("in memory")
+    {
+        const auto bytes = audio::wave_file<TestType>::encode(signal,
+                                                              audio::wave_format::pcm,
+                                                              audio::wave_subformat::pcm_int24);
+        const audio::wave_file<TestType> memory(bytes.data(), bytes.size());
+
+        const auto s = memory.read_at(29000, 2000);
+        REQUIRE(s.size() == 1000);
+        CHECK(s[999][2] == expected[29999][2]);
+    }
+
+    std::filesystem::remove(file);
+}
+
+TEMPLATE_TEST_CASE("wave_file parallel read", "[file][wave_file][read][parallel]", float, double)
+{
+    // Need to use a different file name for each type so tests can run in parallel without conflict
+    const auto test_type = boost::typeindex::type_id<TestType>().pretty_name();
+    const auto file      = "data/wave_files/tmp-parallel-" + test_type + ".wav";
+
+    // Large enough to be split into several ranges
+    constexpr size_t             size = 1000003;
+    audio::multisignal<TestType> signal(48000, size, 3);
+    for (size_t n = 0; n < size; ++n)
+    {
+        for (size_t c = 0; c < signal.channels(); ++c)
+        {
+            signal[n][c] = static_cast<TestType>(static_cast<int>((n * 7 + c * 13) % 2001) - 1000)
+                         / 1000;
+        }
+    }
+
+    audio::wave_file<TestType>(file).write(
+        signal, audio::wave_format::pcm, audio::wave_subformat::pcm_int24);
+
+    audio::wave_file<TestType> stream(file);
+    audio::wave_file<TestType> parallel(file, audio::wave_read_mode::parallel, 4);
+
+    SECTION("whole file")
+    {
+        const auto expected = stream.read();
+        const auto s        = parallel.read();
+
+        REQUIRE(s.size() == expected.size());
+        REQUIRE(s.channels() == expected.channels());
+
+        size_t mismatches = 0;
+        for (size_t n = 0; n < s.size(); ++n)
+        {
+            for (size_t c = 0; c < s.channels(); ++c)
+            {
+                mismatches += s[n][c] != expected[n][c];
+            }
+        }
+
+        CHECK(mismatches == 0);
+    }
+
+    SECTION("range and channel subset")
+    {
+        const auto expected = stream.read(123457, 654321, {2, 0});
+        const auto s        = parallel.read(123457, 654321, {2, 0});
+
+        REQUIRE(s.size() == expected.size());
+        REQUIRE(s.channels() == expected.channels());
+
+        size_t mismatches = 0;
+        for (size_t n = 0; n < s.size(); ++n)
+        {
+            for (size_t c = 0; c < s.channels(); ++c)
+            {
+                mismatches += s[n][c] != expected[n][c];
+            }
+        }
+
+        CHECK(mismatches == 0);
+    }
+
+    std::filesystem::remove(file);
+}
+
+TEMPLATE_TEST_CASE("wave_file::view", "[file][wave_file][view]", float, double)
+{
+    const auto* matching = std::is_same_v<TestType, float> ? "data/wave_files/ieee_float32.wav"
+                                                           : "data/wave_files/ieee_float64.wav";
+
+    SECTION("matching subformat")
+    {
+        audio::wave_file<TestType> w(matching);
+
+        const auto s = w.read();
+        for (size_t c = 0; c < s.channels(); ++c)
+        {
+            const auto view = w.view(c);
+
+            REQUIRE(view.size() == s.size());
+            for (size_t n = 0; n < view.size(); ++n)
+            {
+                CHECK(view[n] == s[n][c]);
+            }
+        }
+
+        REQUIRE_THROWS_AS(w.view(s.channels()), std::out_of_range);
+    }
+
+    SECTION("view outlives file")
+    {
+        auto w    = std::make_unique<audio::wave_file<TestType>>(matching);
+        auto s    = w->read();
+        auto view = w->view(0);
+        w.reset();
+
+        for (size_t n = 0; n < view.size(); ++n)
+        {
+            CHECK(view[n] == s[n][0]);
+        }
+    }
+
+    SECTION("subformat requires conversion")
+    {
+        audio::wave_file<TestType> w("data/wave_files/pcm_int16.wav");
+
+        REQUIRE_THROWS_WITH(w.view(0),
+                            Catch::Matchers::Equals(
+                                "Sample data in wave_file 'data/wave_files/pcm_int16.wav' can't be "
+                                "viewed without conversion"));
+    }
+}
+
+TEMPLATE_TEST_CASE("wave_file in memory", "[file][wave_file][memory]", float, double)
+{
+    for (const auto mode : {audio::wave_read_mode::stream,
+                            audio::wave_read_mode::mapped,
+                            audio::wave_read_mode::parallel})
+    {
+        for (const auto* name :
+             {"pcm_uint8", "pcm_int16", "pcm_int24", "pcm_int32", "ieee_float32", "ieee_float64"})
+        {
+            DYNAMIC_SECTION(name << " mode " << static_cast<int>(mode))
+            {
+                const auto path = std::string("data/wave_files/") + name + ".wav";
+
+                std::ifstream          file(path, std::ios::binary);
+                std::vector<std::byte> bytes(std::filesystem::file_size(path));
+                file.read(reinterpret_cast<char*>(bytes.data()),
+                          static_cast<std::streamsize>(bytes.size()));
+
+                audio::wave_file<TestType> expected_file(path);
+                audio::wave_file<TestType> w(bytes.data(), bytes.size(), mode);
+
+                CHECK(w.sample_rate() == expected_file.sample_rate());
+                CHECK(w.size() == expected_file.size());
+                CHECK(w.channels() == expected_file.channels());
+
+                const auto expected = expected_file.read();
+                const auto s        = w.read();
+
+                REQUIRE(s.size() == expected.size());
+                REQUIRE(s.channels() == expected.channels());
+
+                for (size_t n = 0; n < s.size(); ++n)
+                {
+                    for (size_t c = 0; c < s.channels(); ++c)
+                    {
+                        CHECK(s[n][c] == expected[n][c]);
+                    }
+                }
+
+                CHECK_THROWS_AS(w.write(s), std::runtime_error);
+            }
+        }
+    }
+
+    SECTION("truncated")
+    {
+        const std::vector<std::byte> bytes(8);
+        REQUIRE_THROWS_AS(audio::wave_file<TestType>(bytes.data(), bytes.size()),
+                          std::runtime_error);
+    }
+
+    SECTION("zero channels")
+    {
+        // A mono 16 bit file with its channel count cleared but its block align left at 2
+        const audio::multisignal<TestType> s(44100, 4, 1);
+
+        auto bytes = audio::wave_file<TestType>::encode(s,
+                                                        audio::wave_format::pcm,
+                                                        audio::wave_subformat::pcm_int16);
+
+        const auto format = std::search(bytes.begin(),
+                                        bytes.end(),
+                                        reinterpret_cast<const std::byte*>("fmt "),
+                                        reinterpret_cast<const std::byte*>("fmt ") + 4);
+        REQUIRE(format != bytes.end());
+        format[10] = std::byte{0};
+        format[11] = std::byte{0};
+
+        REQUIRE_THROWS_AS(audio::wave_file<TestType>(bytes.data(), bytes.size()),
+                          std::runtime_error);
+    }
+}
+
+TEMPLATE_TEST_CASE("wave_file::encode", "[file][wave_file][encode]", float, double)
+{
+    const auto signal = signal_from_config<TestType>("data/wave_files/signal.dat");
+
+    // Need to use a different file name for each type so tests can run in parallel without conflict
+    const auto test_type = boost::typeindex::type_id<TestType>().pretty_name();
+    const auto file      = "data/wave_files/tmp-encode-" + test_type + ".wav";
+
+    const std::vector<std::pair<audio::wave_format, audio::wave_subformat>> formats{
+        {audio::wave_format::pcm, audio::wave_subformat::pcm_uint8},
+        {audio::wave_format::pcm, audio::wave_subformat::pcm_int16},
+        {audio::wave_format::pcm, audio::wave_subformat::pcm_int24},
+        {audio::wave_format::pcm, audio::wave_subformat::pcm_int32},
+        {audio::wave_format::ieee_float, audio::wave_subformat::ieee_float32},
+        {audio::wave_format::ieee_float, audio::wave_subformat::ieee_float64}};
+
+    for (const auto& [format, subformat] : formats)
+    {
+        DYNAMIC_SECTION("subformat " << static_cast<int>(subformat))
+        {
+            using wave_file = audio::wave_file<TestType>;
+
+            const auto bytes = wave_file::encode(signal, format, subformat);
+            CHECK(bytes.size() == wave_file::encoded_size(signal, format, subformat));
+
+            // Encoding into memory must produce exactly the same file as writing it
+            wave_file(file).write(signal, format, subformat);
+
+            std::ifstream          stream(file, std::ios::binary);
+            std::vector<std::byte> expected(std::filesystem::file_size(file));
+            stream.read(reinterpret_cast<char*>(expected.data()),
+                        static_cast<std::streamsize>(expected.size()));
+            stream.close();
+
+            std::filesystem::remove(file);
+
+            CHECK(bytes == expected);
+
+            std::vector<std::byte> buffer(bytes.size() - 1);
+            CHECK_THROWS_AS(
+                wave_file::encode(signal, format, subformat, buffer.data(), buffer.size()),
+                std::invalid_argument);
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("wave_file::read_into", "[file][wave_file][read][read_into]", float, double)
+{
+    for (const auto mode : {audio::wave_read_mode::stream,
+                            audio::wave_read_mode::mapped,
+                            audio::wave_read_mode::parallel})
+    {
+        DYNAMIC_SECTION("mode " << static_cast<int>(mode))
+        {
+            audio::wave_file<TestType> w("data/wave_files/pcm_int24.wav", mode);
+
+            const auto expected = w.read();
+
+            // A signal of the wrong shape is replaced, one of the right shape is reused
+            audio::multisignal<TestType> s(w.sample_rate(), 1, 1);
+            for (size_t i = 0; i < 2; ++i)
+            {
+                CHECK(w.read_into(s) == expected.size());
+
+                REQUIRE(s.sample_rate() == expected.sample_rate());
+                REQUIRE(s.size() == expected.size());
+                REQUIRE(s.channels() == expected.channels());
+
+                for (size_t n = 0; n < s.size(); ++n)
+                {
+                    for (size_t c = 0; c < s.channels(); ++c)
+                    {
+                        CHECK(s[n][c] == expected[n][c]);
+                    }
+                }
+            }
+
+            audio::multisignal<TestType> range(w.sample_rate(), 4, w.channels());
+            CHECK(w.read_into(range, 5, 4) == 4);
+
+            for (size_t n = 0; n < range.size(); ++n)
+            {
+                for (size_t c = 0; c < range.channels(); ++c)
+                {
+                    CHECK(range[n][c] == expected[5 + n][c]);
+                }
+            }
+
+            CHECK_THROWS_AS(w.read_into(range, expected.size() + 1, 1), std::out_of_range);
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("wave_file channel selection",
+                   "[file][wave_file][read][channels]",
+                   float,
+                   double)
+{
+    constexpr size_t channels = 8;
+    constexpr size_t frames   = 100;
+
+    audio::multisignal<TestType> signal(48000, frames, channels);
+    for (size_t n = 0; n < frames; ++n)
+    {
+        for (size_t c = 0; c < channels; ++c)
+        {
+            signal[n][c] = static_cast<TestType>((n % 16) / 32.0 - (c / 16.0));
+        }
+    }
+
+    for (const auto subformat : {audio::wave_subformat::pcm_uint8,
+                                 audio::wave_subformat::pcm_int16,
+                                 audio::wave_subformat::pcm_int24,
+                                 audio::wave_subformat::pcm_int32,
+                                 audio::wave_subformat::ieee_float32,
+                                 audio::wave_subformat::ieee_float64})
+    {
+        DYNAMIC_SECTION("subformat " << static_cast<int>(subformat))
+        {
+            const auto format = subformat < audio::wave_subformat::ieee_float32
+                                  ? audio::wave_format::pcm
+                                  : audio::wave_format::ieee_float;
+
+            const auto bytes = audio::wave_file<TestType>::encode(signal, format, subformat);
+
+            audio::wave_file<TestType> w(bytes.data(), bytes.size());
+            CHECK(w.channel_mask() == 0);
+
+            const auto expected = w.read();
+
+            // Few enough channels to only decode their lanes, and enough to decode whole frames
+            for (const auto& selection : {std::vector<size_t>{6, 1},
+                                          std::vector<size_t>{0, 2, 4, 6, 7}})
+            {
+                const auto s = w.read(10, 50, selection);
+
+                REQUIRE(s.size() == 50);
+                REQUIRE(s.channels() == selection.size());
+
+                for (size_t n = 0; n < s.size(); ++n)
+                {
+                    for (size_t c = 0; c < s.channels(); ++c)
+                    {
+                        CHECK(s[n][c] == expected[10 + n][selection[c]]);
+                    }
+                }
+            }
+
+            // Without a channel mask, channel i feeds speaker i
+            CHECK(w.select_channels(0b10000101) == std::vector<size_t>{0, 2, 7});
+            CHECK(w.select_channels(0xFFFFFFFF).size() == channels);
+        }
+    }
+
+    SECTION("WAVE_FORMAT_EXTENSIBLE")
+    {
+        // Quad recording (front left, front right, back left, back right) of 16 bit PCM
+        const uint32_t mask = 0x33;
+
+        std::vector<std::byte> bytes;
+        const auto append = [&bytes](const void* data, size_t size) {
+            const auto* begin = static_cast<const std::byte*>(data);
+            bytes.insert(bytes.end(), begin, begin + size);
+        };
+
+        const auto append_u16 = [&append](uint16_t value) { append(&value, sizeof(value)); };
+        const auto append_u32 = [&append](uint32_t value) { append(&value, sizeof(value)); };
+
+        const uint8_t guid[] = {0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00,
+                                0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71};
+
+        append("RIFF", 4);
+        append_u32(4 + 8 + 40 + 8 + frames * 4 * 2);
+        append("WAVE", 4);
+        append("fmt ", 4);
+        append_u32(40);
+        append_u16(0xFFFE);
+        append_u16(4);
+        append_u32(48000);
+        append_u32(48000 * 4 * 2);
+        append_u16(4 * 2);
+        append_u16(16);
+        append_u16(22);
+        append_u16(16);
+        append_u32(mask);
+        append(guid, sizeof(guid));
+        append("data", 4);
+        append_u32(frames * 4 * 2);
+        for (size_t n = 0; n < frames; ++n)
+        {
+            for (uint16_t c = 0; c < 4; ++c)
+            {
+                append_u16(static_cast<uint16_t>(c * 0x1000 + n));
+            }
+        }
+
+        audio::wave_file<TestType> w(bytes.data(), bytes.size());
+        CHECK(w.channels() == 4);
+        CHECK(w.size() == frames);
+        CHECK(w.channel_mask() == mask);
+
+        // Channels are assigned to the speakers of the mask in order
+        CHECK(w.select_channels(0x30) == std::vector<size_t>{2, 3});
+        CHECK(w.select_channels(0x02) == std::vector<size_t>{1});
+        CHECK(w.select_channels(0x04).empty());
+
+        const auto s = w.read(0, frames, w.select_channels(0x20));
+        REQUIRE(s.channels() == 1);
+        REQUIRE(s.size() == frames);
+
+        for (size_t n = 0; n < frames; ++n)
+        {
+            CHECK(s[n][0] == static_cast<TestType>(3 * 0x1000 + n) / 0x8000);
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("wave_file stats", "[file][wave_file][stats]", float, double)
+{
+    // Need to use a different file name for each type so tests can run in parallel without conflict
+    const auto test_type = boost::typeindex::type_id<TestType>().pretty_name();
+    const auto file      = "data/wave_files/tmp-stats-" + test_type + ".wav";
+
+    for (const auto mode : {audio::wave_read_mode::stream,
+                            audio::wave_read_mode::mapped,
+                            audio::wave_read_mode::parallel})
+    {
+        DYNAMIC_SECTION("mode " << static_cast<int>(mode))
+        {
+            audio::wave_file<TestType> w("data/wave_files/pcm_int24.wav", mode);
+
+            // Nothing is counted until stats are enabled
+            w.read();
+            CHECK(w.stats().bytes_read == 0);
+            CHECK(w.last_stats().bytes_read == 0);
+
+            w.enable_stats(true);
+
+            // Parsing the header on construction is included
+            const auto opened = w.stats();
+            CHECK(opened.bytes_read > 0);
+            CHECK(opened.header_time.count() > 0);
+
+            const auto data_size = w.size() * w.channels() * 3;
+
+            w.read();
+            const auto last = w.last_stats();
+            CHECK(last.bytes_read == data_size);
+            CHECK(last.header_time.count() == 0);
+            CHECK(last.decode_time.count() > 0);
+            CHECK(last.bytes_written == 0);
+            if (mode == audio::wave_read_mode::mapped)
+            {
+                CHECK(last.read_calls == 0);
+            }
+            else
+            {
+                CHECK(last.read_calls > 0);
+            }
+
+            w.read(0, 10);
+            CHECK(w.last_stats().bytes_read == 10 * w.channels() * 3);
+            CHECK(w.stats().bytes_read == opened.bytes_read + data_size + 10 * w.channels() * 3);
+
+            w.enable_stats(false);
+            w.read();
+            CHECK(w.stats().bytes_read == 0);
+        }
+    }
+
+    SECTION("write")
+    {
+        audio::multisignal<TestType> signal(44100, 100, 2);
+
+        audio::wave_file<TestType> w(file);
+        w.enable_stats(true);
+        w.write(signal, audio::wave_format::pcm, audio::wave_subformat::pcm_int16);
+
+        // The header is written before and after the data
+        const auto last = w.last_stats();
+        CHECK(last.bytes_written > 100 * 2 * 2);
+        CHECK(last.write_calls >= 3);
+        CHECK(last.encode_time.count() > 0);
+        CHECK(last.bytes_read == 0);
+
+        std::filesystem::remove(file);
+    }
+}
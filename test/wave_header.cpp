@@ -0,0 +1,128 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <tnt/audio/detail/wave_header.hpp>
+#include <vector>
+
+using namespace tnt;
+
+namespace
+{
+
+// Parses a header from memory
+audio::detail::wave_layout parse(const std::vector<std::byte>& bytes)
+{
+    const auto read = [&bytes](size_t offset, std::byte* data, size_t size) {
+        if (offset + size > bytes.size())
+        {
+            return false;
+        }
+
+        std::memcpy(data, bytes.data() + offset, size);
+        return true;
+    };
+
+    return audio::detail::parse_header("header.wav", read);
+}
+
+std::string id(const std::vector<std::byte>& bytes, size_t position)
+{
+    return std::string(reinterpret_cast<const char*>(bytes.data() + position), 4);
+}
+
+}  // namespace
+
+TEST_CASE("wave_header", "[wave_header]")
+{
+    constexpr size_t channels = 6;
+    constexpr size_t frames   = 1000;
+
+    SECTION("RIFF")
+    {
+        const auto header = audio::detail::make_header("header.wav",
+                                                       audio::wave_format::pcm,
+                                                       audio::wave_subformat::pcm_int24,
+                                                       48000,
+                                                       channels,
+                                                       frames * channels * 3);
+
+        CHECK(id(header.bytes, 0) == "RIFF");
+        CHECK(id(header.bytes, header.ds64_position) == "JUNK");
+
+        const auto layout = parse(header.bytes);
+        CHECK(layout.subformat == audio::wave_subformat::pcm_int24);
+        CHECK(layout.sample_rate == 48000);
+        CHECK(layout.channels == channels);
+        CHECK(layout.size == frames);
+        CHECK(layout.data_position == header.bytes.size());
+    }
+
+    SECTION("RF64")
+    {
+        // Larger than a 32 bit size can describe
+        constexpr uint64_t large_frames = (uint64_t{1} << 32) / (channels * 8) + frames;
+
+        auto header = audio::detail::make_header("header.wav",
+                                                 audio::wave_format::ieee_float,
+                                                 audio::wave_subformat::ieee_float64,
+                                                 192000,
+                                                 channels,
+                                                 large_frames * channels * 8);
+
+        CHECK(id(header.bytes, 0) == "RF64");
+        CHECK(id(header.bytes, header.ds64_position) == "ds64");
+
+        const auto layout = parse(header.bytes);
+        CHECK(layout.subformat == audio::wave_subformat::ieee_float64);
+        CHECK(layout.size == large_frames);
+        CHECK(layout.data_position == header.bytes.size());
+
+        // BW64 only differs in its identifier
+        std::memcpy(header.bytes.data(), "BW64", 4);
+        CHECK(parse(header.bytes).size == large_frames);
+
+        // Shrinking the data switches the header back to RIFF
+        audio::detail::set_data_size(header, frames * channels * 8);
+        CHECK(id(header.bytes, 0) == "RIFF");
+        CHECK(parse(header.bytes).size == frames);
+    }
+
+    SECTION("invalid format")
+    {
+        auto header = audio::detail::make_header("header.wav",
+                                                 audio::wave_format::pcm,
+                                                 audio::wave_subformat::pcm_int16,
+                                                 44100,
+                                                 channels,
+                                                 frames * channels * 2);
+
+        // The channel count and block align follow the 8 byte chunk header and the format tag
+        size_t format_position = 12;
+        while (id(header.bytes, format_position) != "fmt ")
+        {
+            uint32_t size{};
+            std::memcpy(&size, header.bytes.data() + format_position + 4, sizeof(size));
+            format_position += 8 + size;
+        }
+
+        const auto set = [&](size_t offset, uint16_t value) {
+            std::memcpy(header.bytes.data() + format_position + 8 + offset, &value, sizeof(value));
+        };
+
+        CHECK(parse(header.bytes).size == frames);
+
+        // A frame of zero channels would make every frame zero bytes long
+        set(2, 0);
+        CHECK_THROWS_AS(parse(header.bytes), std::runtime_error);
+        set(2, channels);
+
+        // Padded frames don't match the size samples are decoded with
+        set(12, channels * 2 + 2);
+        CHECK_THROWS_AS(parse(header.bytes), std::runtime_error);
+        set(12, 0);
+        CHECK_THROWS_AS(parse(header.bytes), std::runtime_error);
+    }
+}
@@ -0,0 +1,105 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <cstddef>
+#include <stdexcept>
+#include <tnt/audio/multisignal.hpp>
+#include <tnt/audio/wave_file.hpp>
+#include <tnt/audio/wave_lazy_signal.hpp>
+
+using namespace tnt;
+
+TEMPLATE_TEST_CASE("wave_lazy_signal", "[wave_lazy_signal]", float, double)
+{
+    for (const auto mode : {audio::wave_read_mode::stream, audio::wave_read_mode::mapped})
+    {
+        DYNAMIC_SECTION("mode " << static_cast<int>(mode))
+        {
+            audio::wave_file<TestType> w("data/wave_files/pcm_int24.wav", mode);
+            const auto                 expected = w.read();
+
+            w.enable_stats(true);
+            const auto opened = w.stats();
+
+            const auto lazy = w.read_lazy(3, 2);
+
+            // The shape is known without decoding anything
+            CHECK(lazy.sample_rate() == w.sample_rate());
+            CHECK(lazy.size() == w.size());
+            CHECK(lazy.channels() == w.channels());
+            CHECK(lazy.page_frames() == 3);
+            CHECK(lazy.cache_pages() == 2);
+            CHECK(lazy.cached_pages() == 0);
+            CHECK(w.stats().bytes_read == opened.bytes_read);
+
+            // Only the page of the accessed frame is decoded
+            const auto first = lazy[7];
+            CHECK(lazy.cached_pages() == 1);
+            CHECK(w.stats().bytes_read == opened.bytes_read + 3 * w.channels() * 3);
+            REQUIRE(first.size() == w.channels());
+
+            for (size_t c = 0; c < w.channels(); ++c)
+            {
+                CHECK(first[c] == expected[7][c]);
+            }
+
+            // Scattered accesses match a full read, and the cache stays bounded
+            for (size_t n = 0; n < expected.size(); n += 5)
+            {
+                for (size_t c = 0; c < expected.channels(); ++c)
+                {
+                    CHECK(lazy[n][c] == expected[n][c]);
+                    CHECK(lazy.at(n, c) == expected[n][c]);
+                }
+
+                CHECK(lazy.cached_pages() <= 2);
+            }
+
+            // The last page is partial
+            const auto last = expected.size() - 1;
+            CHECK(lazy[last][0] == expected[last][0]);
+
+            // Frames stay valid after their page is evicted
+            CHECK(first[0] == expected[7][0]);
+
+            CHECK_THROWS_AS(lazy.at(expected.size(), 0), std::out_of_range);
+            CHECK_THROWS_AS(lazy.at(0, expected.channels()), std::out_of_range);
+        }
+    }
+
+    SECTION("default page size")
+    {
+        audio::wave_file<TestType> w("data/wave_files/ieee_float32.wav");
+        const auto                 expected = w.read();
+        const auto                 lazy     = w.read_lazy();
+
+        CHECK(lazy.page_frames() > 0);
+        CHECK(lazy.cache_pages() == 64);
+
+        for (size_t n = 0; n < expected.size(); ++n)
+        {
+            CHECK(lazy[n][0] == expected[n][0]);
+        }
+    }
+
+    SECTION("single page cache")
+    {
+        audio::wave_file<TestType> w("data/wave_files/pcm_int16.wav");
+        const auto                 expected = w.read();
+        const auto                 lazy     = w.read_lazy(4, 1);
+
+        // Alternating between two pages evicts the most recently used page every time
+        for (size_t i = 0; i < 4; ++i)
+        {
+            const auto n = (i % 2 == 0) ? 1 : 5;
+            CHECK(lazy.at(n, 0) == expected[n][0]);
+            CHECK(lazy.at(n + 1, 0) == expected[n + 1][0]);
+            CHECK(lazy.cached_pages() == 1);
+        }
+    }
+
+    SECTION("invalid cache")
+    {
+        audio::wave_file<TestType> w("data/wave_files/pcm_int16.wav");
+        CHECK_THROWS_AS(w.read_lazy(0, 0), std::invalid_argument);
+        CHECK_THROWS_AS(w.read_lazy(10, 0), std::invalid_argument);
+    }
+}
@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <boost/type_index.hpp>
+#include <catch2/catch_template_test_macros.hpp>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <tnt/audio/multisignal.hpp>
+#include <tnt/audio/wave_file.hpp>
+#include <tnt/audio/wave_overview.hpp>
+
+using namespace tnt;
+
+TEMPLATE_TEST_CASE("wave_overview", "[wave_overview]", float, double)
+{
+    constexpr size_t channels = 3;
+    constexpr size_t frames   = 10000;
+
+    audio::multisignal<TestType> signal(48000, frames, channels);
+    for (size_t n = 0; n < frames; ++n)
+    {
+        for (size_t c = 0; c < channels; ++c)
+        {
+            signal[n][c] = static_cast<TestType>(std::sin(0.01 * (c + 1) * n) * 0.5);
+        }
+    }
+
+    // Need to use a different file name for each type so tests can run in parallel without conflict
+    const auto test_type = boost::typeindex::type_id<TestType>().pretty_name();
+    const auto file      = "data/wave_files/tmp-overview-" + test_type + ".wav";
+    const auto sidecar   = file + ".overview";
+
+    audio::wave_file<TestType>(file).write(signal,
+                                           audio::wave_format::ieee_float,
+                                           audio::wave_subformat::ieee_float32);
+
+    audio::wave_file<TestType> w(file);
+
+    SECTION("build")
+    {
+        const auto overview = audio::wave_overview::build(w, 100, 4, 3);
+
+        CHECK(overview.sample_rate() == 48000);
+        CHECK(overview.size() == frames);
+        CHECK(overview.channels() == channels);
+        REQUIRE(overview.levels() == 3);
+        CHECK(overview.frames_per_bucket(2) == 1600);
+        CHECK(overview.buckets(2) == 7);
+
+        for (size_t level = 0; level < overview.levels(); ++level)
+        {
+            const auto step = overview.frames_per_bucket(level);
+            for (size_t c = 0; c < channels; ++c)
+            {
+                const auto buckets = overview.query(level, 0, frames, c);
+                REQUIRE(buckets.size() == overview.buckets(level));
+
+                // Every bucket must match a direct computation over its frames
+                for (size_t b = 0; b < buckets.size(); ++b)
+                {
+                    const auto start = b * step;
+                    const auto end   = std::min(frames, start + step);
+
+                    auto   min         = static_cast<float>(signal[start][c]);
+                    auto   max         = min;
+                    double sum_squares = 0;
+                    for (size_t n = start; n < end; ++n)
+                    {
+                        const auto sample = static_cast<float>(signal[n][c]);
+                        min               = std::min(min, sample);
+                        max               = std::max(max, sample);
+                        sum_squares += static_cast<double>(sample) * sample;
+                    }
+
+                    CHECK(buckets[b].min == min);
+                    CHECK(buckets[b].max == max);
+                    CHECK(std::abs(buckets[b].rms - std::sqrt(sum_squares / (end - start)))
+                          < 1e-6);
+                }
+            }
+        }
+
+        // Range queries return the buckets overlapping the range
+        const auto range = overview.query(1, 450, 400, 2);
+        REQUIRE(range.size() == 2);
+        CHECK(range[0].min == overview.query(1, 400, 1, 2)[0].min);
+        CHECK(overview.query(0, frames, 10, 0).empty());
+
+        CHECK(overview.level_for(50) == 0);
+        CHECK(overview.level_for(500) == 1);
+        CHECK(overview.level_for(100000) == 2);
+
+        CHECK_THROWS_AS(overview.query(3, 0, 1, 0), std::out_of_range);
+        CHECK_THROWS_AS(overview.query(0, 0, 1, channels), std::out_of_range);
+        CHECK_THROWS_AS(overview.query(0, frames + 1, 1, 0), std::out_of_range);
+        CHECK_THROWS_AS(audio::wave_overview::build(w, 100, 1, 3), std::invalid_argument);
+    }
+
+    SECTION("sidecar")
+    {
+        std::filesystem::remove(sidecar);
+        CHECK(!audio::wave_overview::load(sidecar, file));
+
+        const auto built = audio::wave_overview::open(file, sidecar, 64, 8, 4);
+        REQUIRE(std::filesystem::exists(sidecar));
+
+        const auto loaded = audio::wave_overview::load(sidecar, file);
+        REQUIRE(loaded);
+        REQUIRE(loaded->levels() == built.levels());
+
+        for (size_t level = 0; level < built.levels(); ++level)
+        {
+            const auto expected = built.query(level, 0, frames, 1);
+            const auto actual   = loaded->query(level, 0, frames, 1);
+            REQUIRE(actual.size() == expected.size());
+
+            for (size_t b = 0; b < actual.size(); ++b)
+            {
+                CHECK(actual[b].min == expected[b].min);
+                CHECK(actual[b].max == expected[b].max);
+                CHECK(actual[b].rms == expected[b].rms);
+            }
+        }
+
+        // A different decimation rebuilds the sidecar
+        CHECK(audio::wave_overview::open(file, sidecar, 128, 2, 2).levels() == 2);
+        CHECK(audio::wave_overview::load(sidecar, file)->levels() == 2);
+
+        // Rewriting the wave file makes the sidecar out of date
+        audio::multisignal<TestType> shorter(48000, frames / 2, channels);
+        audio::wave_file<TestType>(file).write(shorter,
+                                               audio::wave_format::ieee_float,
+                                               audio::wave_subformat::ieee_float32);
+        CHECK(!audio::wave_overview::load(sidecar, file));
+        CHECK(audio::wave_overview::open(file, sidecar, 128, 2, 2).size() == frames / 2);
+
+        std::filesystem::remove(sidecar);
+    }
+
+    SECTION("levels")
+    {
+        // Levels stop once one bucket covers the file, rather than multiplying the frames per
+        // bucket until they overflow
+        const auto overview = audio::wave_overview::build(w, 256, 4, 40);
+        REQUIRE(overview.levels() == 4);
+        CHECK(overview.frames_per_bucket(3) == 16384);
+        CHECK(overview.buckets(3) == 1);
+        CHECK(overview.level_for(std::numeric_limits<size_t>::max()) == 3);
+        CHECK_THROWS_AS(overview.frames_per_bucket(4), std::out_of_range);
+
+        CHECK(audio::wave_overview::build(w, 100, std::numeric_limits<size_t>::max(), 3).levels()
+              == 1);
+
+        // Reopening finds the sidecar it saved instead of failing or rebuilding
+        std::filesystem::remove(sidecar);
+        CHECK(audio::wave_overview::open(file, sidecar, 256, 4, 40).levels() == 4);
+
+        const auto time   = std::filesystem::last_write_time(sidecar);
+        const auto reopen = audio::wave_overview::open(file, sidecar, 256, 4, 40);
+        CHECK(reopen.levels() == 4);
+        CHECK(reopen.query(3, 0, frames, 1)[0].max == overview.query(3, 0, frames, 1)[0].max);
+        CHECK(std::filesystem::last_write_time(sidecar) == time);
+
+        // A damaged header is rejected before anything is allocated for it
+        const auto damage = [&](size_t offset, uint64_t value) {
+            audio::wave_overview::open(file, sidecar, 256, 4, 40);
+
+            std::fstream stream(sidecar, std::ios::binary | std::ios::in | std::ios::out);
+            stream.seekp(static_cast<std::streamoff>(offset));
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+            stream.close();
+
+            return !audio::wave_overview::load(sidecar, file);
+        };
+
+        // Offsets of the channels and levels fields of the header
+        CHECK(damage(40, 0));
+        CHECK(damage(40, uint64_t{1} << 62));
+        CHECK(damage(64, 0));
+        CHECK(damage(64, uint64_t{1} << 40));
+        CHECK(damage(64, 3));
+
+        std::filesystem::remove(sidecar);
+    }
+
+    std::filesystem::remove(file);
+}
@@ -0,0 +1,39 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <filesystem>
+#include <string>
+#include <tnt/audio/wave_file.hpp>
+#include <tnt/audio/wave_probe.hpp>
+#include <vector>
+
+using namespace tnt;
+
+TEST_CASE("probe_wave_files", "[wave_probe]")
+{
+    const std::vector<std::filesystem::path> paths{"data/wave_files/pcm_uint8.wav",
+                                                   "data/wave_files/pcm_int24.wav",
+                                                   "data/wave_files/ieee_float64.wav",
+                                                   "data/wave_files/empty.wav",
+                                                   "data/wave_files/nonexistent.wav"};
+
+    const auto infos = audio::probe_wave_files(paths, 2);
+    REQUIRE(infos.size() == paths.size());
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+        audio::wave_file<double> w(paths[i]);
+
+        CHECK(infos[i].path == paths[i]);
+        CHECK(infos[i].error.empty());
+        CHECK(infos[i].sample_rate == w.sample_rate());
+        CHECK(infos[i].channels == w.channels());
+        CHECK(infos[i].size == w.size());
+        CHECK(infos[i].duration == w.duration());
+    }
+
+    CHECK(infos[0].subformat == audio::wave_subformat::pcm_uint8);
+    CHECK(infos[1].subformat == audio::wave_subformat::pcm_int24);
+    CHECK(infos[2].subformat == audio::wave_subformat::ieee_float64);
+
+    CHECK(infos[3].error == "Invalid RIFF header for wave_file '" + paths[3].string() + "'");
+    CHECK(infos[4].error == "Failed to open wave_file '" + paths[4].string() + "'");
+}
@@ -0,0 +1,94 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <tnt/audio/multisignal.hpp>
+#include <tnt/audio/wave_file.hpp>
+#include <tnt/audio/wave_reader.hpp>
+
+using namespace tnt;
+
+TEMPLATE_TEST_CASE("wave_reader::read", "[wave_reader][read]", float, double)
+{
+    for (const auto mode : {audio::wave_read_mode::stream, audio::wave_read_mode::mapped})
+    {
+        for (const auto* name :
+             {"pcm_uint8", "pcm_int16", "pcm_int24", "pcm_int32", "ieee_float32", "ieee_float64"})
+        {
+            DYNAMIC_SECTION(name << (mode == audio::wave_read_mode::mapped ? " mapped" : ""))
+            {
+                audio::wave_file<TestType> w(std::string("data/wave_files/") + name + ".wav", mode);
+
+                const auto expected = w.read();
+
+                // A block size that doesn't divide the file exercises the final partial block
+                auto reader = w.open_reader();
+                audio::multisignal<TestType> block(reader.sample_rate(), 7, reader.channels());
+
+                CHECK(reader.sample_rate() == w.sample_rate());
+                CHECK(reader.size() == w.size());
+                CHECK(reader.channels() == w.channels());
+
+                size_t position = 0;
+                while (const auto frames = reader.read(block))
+                {
+                    REQUIRE(position + frames <= expected.size());
+
+                    for (size_t n = 0; n < frames; ++n)
+                    {
+                        for (size_t c = 0; c < block.channels(); ++c)
+                        {
+                            CHECK(block[n][c] == expected[position + n][c]);
+                        }
+                    }
+
+                    position += frames;
+                    CHECK(reader.position() == position);
+                }
+
+                CHECK(position == expected.size());
+                CHECK(reader.read(block) == 0);
+            }
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("wave_reader::seek", "[wave_reader][seek]", float, double)
+{
+    for (const auto mode : {audio::wave_read_mode::stream, audio::wave_read_mode::mapped})
+    {
+        audio::wave_file<TestType> w("data/wave_files/pcm_int24.wav", mode);
+
+        const auto expected = w.read();
+
+        auto reader = w.open_reader();
+        audio::multisignal<TestType> block(reader.sample_rate(), 4, reader.channels());
+
+        reader.seek(10);
+        REQUIRE(reader.read(block) == 4);
+        CHECK(reader.position() == 14);
+
+        for (size_t n = 0; n < block.size(); ++n)
+        {
+            for (size_t c = 0; c < block.channels(); ++c)
+            {
+                CHECK(block[n][c] == expected[10 + n][c]);
+            }
+        }
+
+        reader.seek(reader.size() + 1);
+        CHECK(reader.position() == reader.size());
+        CHECK(reader.read(block) == 0);
+    }
+}
+
+TEMPLATE_TEST_CASE("wave_reader channel mismatch", "[wave_reader][read]", float, double)
+{
+    audio::wave_file<TestType> w("data/wave_files/pcm_int16.wav");
+
+    auto reader = w.open_reader();
+    audio::multisignal<TestType> block(reader.sample_rate(), 4, reader.channels() + 1);
+
+    REQUIRE_THROWS_AS(reader.read(block), std::invalid_argument);
+}
@@ -0,0 +1,78 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <tnt/audio/wave_file.hpp>
+#include <tnt/audio/wave_transcode.hpp>
+#include <utility>
+#include <vector>
+
+using namespace tnt;
+
+namespace
+{
+
+std::vector<std::byte> read_bytes(const std::filesystem::path& path)
+{
+    std::ifstream          stream(path, std::ios::binary);
+    std::vector<std::byte> bytes(std::filesystem::file_size(path));
+    stream.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+    return bytes;
+}
+
+}  // namespace
+
+TEST_CASE("transcode_wave_file", "[wave_transcode]")
+{
+    const std::vector<std::pair<audio::wave_format, audio::wave_subformat>> formats{
+        {audio::wave_format::pcm, audio::wave_subformat::pcm_uint8},
+        {audio::wave_format::pcm, audio::wave_subformat::pcm_int16},
+        {audio::wave_format::pcm, audio::wave_subformat::pcm_int24},
+        {audio::wave_format::pcm, audio::wave_subformat::pcm_int32},
+        {audio::wave_format::ieee_float, audio::wave_subformat::ieee_float32},
+        {audio::wave_format::ieee_float, audio::wave_subformat::ieee_float64}};
+
+    const auto output   = std::string("data/wave_files/tmp-transcode.wav");
+    const auto expected = std::string("data/wave_files/tmp-transcode-expected.wav");
+
+    for (const auto* name :
+         {"pcm_uint8", "pcm_int16", "pcm_int24", "pcm_int32", "ieee_float32", "ieee_float64"})
+    {
+        for (const auto& [format, subformat] : formats)
+        {
+            DYNAMIC_SECTION(name << " to subformat " << static_cast<int>(subformat))
+            {
+                const auto input = std::string("data/wave_files/") + name + ".wav";
+
+                audio::wave_file<double> w(input);
+                CHECK(audio::transcode_wave_file(input, output, format, subformat) == w.size());
+
+                // Must produce exactly the same file as a full read and write
+                audio::wave_file<double>(expected).write(w.read(), format, subformat);
+                CHECK(read_bytes(output) == read_bytes(expected));
+
+                std::filesystem::remove(output);
+                std::filesystem::remove(expected);
+            }
+        }
+    }
+
+    SECTION("invalid")
+    {
+        const auto input = std::string("data/wave_files/pcm_int16.wav");
+
+        CHECK_THROWS_AS(audio::transcode_wave_file(input,
+                                                   input,
+                                                   audio::wave_format::pcm,
+                                                   audio::wave_subformat::pcm_int24),
+                        std::invalid_argument);
+        CHECK_THROWS_AS(audio::transcode_wave_file("data/wave_files/nonexistent.wav",
+                                                   output,
+                                                   audio::wave_format::pcm,
+                                                   audio::wave_subformat::pcm_int24),
+                        std::runtime_error);
+    }
+}
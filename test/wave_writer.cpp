@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <boost/type_index.hpp>
+#include <catch2/catch_template_test_macros.hpp>
+#include <cstddef>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <tnt/audio/multisignal.hpp>
+#include <tnt/audio/wave_file.hpp>
+#include <tnt/audio/wave_writer.hpp>
+
+using namespace tnt;
+
+TEMPLATE_TEST_CASE("wave_writer::write", "[wave_writer][write]", float, double)
+{
+    audio::wave_file<TestType> source("data/wave_files/ieee_float64.wav");
+    const auto                 expected = source.read();
+
+    // Need to use a different file name for each type so tests can run in parallel without conflict
+    const auto test_type = boost::typeindex::type_id<TestType>().pretty_name();
+    const auto file      = "data/wave_files/tmp-writer-" + test_type + ".wav";
+
+    SECTION("blocks")
+    {
+        {
+            audio::wave_file<TestType> w(file);
+            auto writer = w.open_writer(expected.sample_rate(), expected.channels());
+
+            // A block size that doesn't divide the signal exercises the final partial block
+            audio::multisignal<TestType> block(expected.sample_rate(), 7, expected.channels());
+            for (size_t position = 0; position < expected.size(); position += block.size())
+            {
+                const auto frames = std::min(block.size(), expected.size() - position);
+                for (size_t n = 0; n < frames; ++n)
+                {
+                    for (size_t c = 0; c < block.channels(); ++c)
+                    {
+                        block[n][c] = expected[position + n][c];
+                    }
+                }
+
+                writer.write(block, frames);
+                CHECK(writer.size() == position + frames);
+            }
+
+            writer.finalize();
+
+            // Writing after finalizing is an error, finalizing again is not
+            CHECK_THROWS_AS(writer.write(block), std::runtime_error);
+            CHECK_NOTHROW(writer.finalize());
+        }
+
+        audio::wave_file<TestType> w(file);
+        const auto                 s = w.read();
+
+        std::filesystem::remove(file);
+
+        CHECK(w.sample_rate() == expected.sample_rate());
+        REQUIRE(s.size() == expected.size());
+        REQUIRE(s.channels() == expected.channels());
+        for (size_t n = 0; n < s.size(); ++n)
+        {
+            for (size_t c = 0; c < s.channels(); ++c)
+            {
+                CHECK(s[n][c] == expected[n][c]);
+            }
+        }
+    }
+
+    SECTION("destructor finalizes")
+    {
+        {
+            audio::wave_file<TestType> w(file);
+            auto writer = w.open_writer(expected.sample_rate(),
+                                        expected.channels(),
+                                        audio::wave_format::pcm,
+                                        audio::wave_subformat::pcm_int16);
+            writer.write(expected);
+        }
+
+        audio::wave_file<TestType> w(file);
+
+        std::filesystem::remove(file);
+
+        CHECK(w.size() == expected.size());
+        CHECK(w.channels() == expected.channels());
+        CHECK(w.sample_rate() == expected.sample_rate());
+    }
+
+    SECTION("empty")
+    {
+        {
+            audio::wave_file<TestType> w(file);
+            w.open_writer(expected.sample_rate(), expected.channels()).finalize();
+        }
+
+        audio::wave_file<TestType> w(file);
+
+        std::filesystem::remove(file);
+
+        CHECK(w.size() == 0);
+        CHECK(w.channels() == expected.channels());
+    }
+
+    SECTION("channel mismatch")
+    {
+        audio::wave_file<TestType> w(file);
+        auto writer = w.open_writer(expected.sample_rate(), expected.channels() + 1);
+
+        CHECK_THROWS_AS(writer.write(expected), std::invalid_argument);
+
+        writer.finalize();
+        std::filesystem::remove(file);
+    }
+}